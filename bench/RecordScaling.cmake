@@ -0,0 +1,54 @@
+# Runs the application's headless benchmark inline and then on 1 to MAX_THREADS recording threads, and tabulates the median command
+# recording time of each run with its speed-up over one thread. Every run also leaves its full report in record_scaling_<threads>.json.
+# usage: cmake -DAPPLICATION=<vulkan_tutorial> [-DMAX_THREADS=<n>] [-DDRAW_COPIES=<n>] [-DFRAMES=<n>] -P RecordScaling.cmake
+
+if (NOT DEFINED MAX_THREADS)
+    cmake_host_system_information(RESULT MAX_THREADS QUERY NUMBER_OF_LOGICAL_CORES)
+endif()
+if (NOT DEFINED DRAW_COPIES)
+    set(DRAW_COPIES 1000)
+endif()
+if (NOT DEFINED FRAMES)
+    set(FRAMES 300)
+endif()
+
+# median recording time in microseconds; the report prints milliseconds to three places
+function(measure_recording NAME RESULT)
+    execute_process(COMMAND ${APPLICATION} --headless --bench ${FRAMES} --bench-output record_scaling_${NAME}.json --draw-copies ${DRAW_COPIES} ${ARGN}
+                    OUTPUT_VARIABLE output
+                    ERROR_VARIABLE output
+                    RESULT_VARIABLE status)
+    if (NOT status EQUAL 0)
+        message(FATAL_ERROR "${APPLICATION} ${ARGN} failed (${status}):\n${output}")
+    endif()
+    if (NOT output MATCHES "recorded [0-9]+ draws a frame [^:]*: p50 ([0-9]+)\\.([0-9][0-9][0-9]) ms")
+        message(FATAL_ERROR "no recording time in the output of ${APPLICATION} ${ARGN}:\n${output}")
+    endif()
+    math(EXPR microseconds "${CMAKE_MATCH_1} * 1000 + 1${CMAKE_MATCH_2} - 1000")
+    set(${RESULT} ${microseconds} PARENT_SCOPE)
+endfunction()
+
+function(print_row LABEL MICROSECONDS BASELINE)
+    set(divisor ${MICROSECONDS})
+    if (divisor EQUAL 0)
+        set(divisor 1)
+    endif()
+    math(EXPR speedup "100 * ${BASELINE} / ${divisor}")
+    math(EXPR whole "${speedup} / 100")
+    math(EXPR hundredths "${speedup} % 100 + 100")
+    string(SUBSTRING ${hundredths} 1 2 hundredths)
+    message("${LABEL}\t${MICROSECONDS} us\t${whole}.${hundredths}x")
+endfunction()
+
+message("${DRAW_COPIES} copies of every draw, ${FRAMES} frames a run")
+measure_recording(inline inline_us)
+measure_recording(1 single_us --record-threads 1)
+message("threads\tp50\tspeed-up")
+print_row(inline ${inline_us} ${single_us})
+print_row(1 ${single_us} ${single_us})
+if (MAX_THREADS GREATER 1)
+    foreach (threads RANGE 2 ${MAX_THREADS})
+        measure_recording(${threads} threads_us --record-threads ${threads})
+        print_row(${threads} ${threads_us} ${single_us})
+    endforeach()
+endif()
@@ -0,0 +1,213 @@
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "MipChain.hpp"
+#include "TexelExpansion.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fmt/format.h>
+#include <memory>
+#include <span>
+#include <stb_image.h>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Loads a texture into a stand-in for mapped staging memory the way makeTextureImage used to (stb widens to RGBA in a heap buffer,
+// the CPU mip chain is built in a vector, then everything is copied) or the way it does now (stb's native channels are widened
+// straight into staging, where the chain is then built in place). Peak RSS only ever grows, so each path runs in its own process.
+// An image ending in .raw, as written by convert, is read without decoding, which takes PNG inflate out of the timings.
+// usage: texture_load_bench <image> legacy|direct [mips]
+//        texture_load_bench <image> convert <out.raw>
+
+namespace
+{
+using namespace HelloTriangle;
+using Clock = std::chrono::steady_clock;
+
+// host staging memory stands in for the mapped Vulkan buffer; touching it once makes it resident as the mapping would be
+auto makeStaging(std::size_t const size) -> std::unique_ptr<std::byte[]>
+{
+	auto staging = std::make_unique_for_overwrite<std::byte[]>(size);
+	std::fill_n(staging.get(), size, std::byte{});
+	return staging;
+}
+
+// width, height and channels, each a little-endian std::uint32_t, then the texels
+using RawHeader = std::array<std::uint32_t, 3>;
+
+auto isRaw(std::string_view const path) -> bool { return path.ends_with(".raw"); }
+
+// allocates as stbi_load does: a malloc'd buffer at the file's channel count, widened into a second one when RGBA is requested; the
+// result is released with stbi_image_free, which is free() unless stb is configured otherwise
+auto loadRaw(char const* const path, int* const width, int* const height, int* const channels, int const requested) -> unsigned char*
+{
+	auto const file = std::unique_ptr<std::FILE, decltype(&std::fclose)>{std::fopen(path, "rb"), &std::fclose};
+	auto       header = RawHeader{};
+	if (not file or std::fread(header.data(), sizeof(header), 1u, file.get()) != 1u or header[2] == 0u or header[2] > 4u) {
+		return nullptr;
+	}
+
+	auto const [w, h, c] = header;
+	auto const texels    = std::size_t{w} * h;
+	auto const native    = static_cast<unsigned char*>(std::malloc(texels * c));
+	if (native == nullptr or std::fread(native, c, texels, file.get()) != texels) {
+		std::free(native);
+		return nullptr;
+	}
+	*width    = static_cast<int>(w);
+	*height   = static_cast<int>(h);
+	*channels = static_cast<int>(c);
+	if (requested == 0 or requested == static_cast<int>(c)) {
+		return native;
+	}
+	if (requested != STBI_rgb_alpha) {
+		std::free(native);
+		return nullptr;
+	}
+
+	// stb's own per-texel conversion: grey fills red, green and blue, and a missing alpha is opaque
+	auto const rgba = static_cast<unsigned char*>(std::malloc(texels * 4u));
+	for (auto i = std::size_t{0}; i < texels and rgba != nullptr; ++i) {
+		auto const* const in  = native + i * c;
+		auto* const       out = rgba + i * 4u;
+		out[0]                = in[0];
+		out[1]                = c >= 3u ? in[1] : in[0];
+		out[2]                = c >= 3u ? in[2] : in[0];
+		out[3]                = c == 2u ? in[1] : c == 4u ? in[3] : 255u;
+	}
+	std::free(native);
+
+	return rgba;
+}
+
+auto loadPixels(char const* const path, int* const width, int* const height, int* const channels, int const requested) -> unsigned char*
+{
+	return isRaw(path) ? loadRaw(path, width, height, channels, requested) : stbi_load(path, width, height, channels, requested);
+}
+
+auto convertToRaw(char const* const path, char const* const output) -> void
+{
+	int        width, height, channels;
+	auto const pixels = stbi_load(path, &width, &height, &channels, 0);
+	if (pixels == nullptr) {
+		throw std::runtime_error{fmt::format("failed to load {}", path)};
+	}
+
+	auto const header = RawHeader{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), static_cast<std::uint32_t>(channels)};
+	auto const size   = static_cast<std::size_t>(width) * height * channels;
+	auto const file   = std::unique_ptr<std::FILE, decltype(&std::fclose)>{std::fopen(output, "wb"), &std::fclose};
+	auto const wrote  = file and std::fwrite(header.data(), sizeof(header), 1u, file.get()) == 1u and
+	                   std::fwrite(pixels, 1u, size, file.get()) == size;
+	stbi_image_free(pixels);
+	if (not wrote) {
+		throw std::runtime_error{fmt::format("failed to write {}", output)};
+	}
+}
+
+auto loadLegacy(char const* const path, bool const mips) -> std::size_t
+{
+	int        width, height, channels;
+	auto const pixels = loadPixels(path, &width, &height, &channels, STBI_rgb_alpha);
+	if (pixels == nullptr) {
+		throw std::runtime_error{fmt::format("failed to load {}", path)};
+	}
+	auto const rgba = std::as_bytes(std::span{pixels, static_cast<std::size_t>(width) * height * STBI_rgb_alpha});
+
+	auto const chain   = mips ? buildSrgbMipChain(rgba, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)) : MipChain{};
+	auto const source  = mips ? std::span<std::byte const>{chain.texels} : rgba;
+	auto const staging = makeStaging(source.size());
+	std::ranges::copy(source, staging.get());
+	stbi_image_free(pixels);
+
+	return source.size();
+}
+
+auto loadDirect(char const* const path, bool const mips) -> std::size_t
+{
+	int        width, height, channels;
+	auto const pixels = loadPixels(path, &width, &height, &channels, 0);
+	if (pixels == nullptr) {
+		throw std::runtime_error{fmt::format("failed to load {}", path)};
+	}
+	auto const source = std::as_bytes(std::span{pixels, static_cast<std::size_t>(width) * height * channels});
+
+	auto const levels  = mips ? mipChainLevels(static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height))
+	                          : std::vector{MipLevel{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), 0u}};
+	auto const size    = mipChainSize(levels);
+	auto const staging = makeStaging(size);
+	expandToRgba(source, static_cast<std::uint32_t>(channels), {staging.get(), size});
+	stbi_image_free(pixels);
+	if (mips) {
+		downsampleSrgbMipChain({staging.get(), size}, levels);
+	}
+
+	return size;
+}
+
+// in KiB
+auto peakResidentSetSize() -> std::size_t
+{
+#ifdef _WIN32
+	auto counters = PROCESS_MEMORY_COUNTERS{};
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize / 1024u;
+#else
+	auto usage = rusage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+}
+}// namespace
+
+auto main(int argc, char* argv[]) -> int
+try {
+	if (argc < 3) {
+		throw std::invalid_argument{
+		    "usage: texture_load_bench <image> legacy|direct [mips]\n"
+		    "       texture_load_bench <image> convert <out.raw>"};
+	}
+	auto const mode = std::string_view{argv[2]};
+	if (mode == "convert") {
+		if (argc < 4) {
+			throw std::invalid_argument{"convert needs an output path"};
+		}
+		convertToRaw(argv[1], argv[3]);
+		return EXIT_SUCCESS;
+	}
+	auto const mips = argc > 3 and std::string_view{argv[3]} == "mips";
+	if (mode != "legacy" and mode != "direct") {
+		throw std::invalid_argument{fmt::format("unknown mode '{}', expected legacy or direct", mode)};
+	}
+
+	auto const baseline = peakResidentSetSize();
+	auto const start    = Clock::now();
+	auto const staged   = mode == "legacy" ? loadLegacy(argv[1], mips) : loadDirect(argv[1], mips);
+	auto const elapsed  = std::chrono::duration<double, std::milli>{Clock::now() - start};
+
+	fmt::print("{} {}: {:.1f} KiB staged in {:.2f} ms, peak RSS {} KiB ({} KiB above startup)\n",
+	           mode,
+	           mips ? "with mips" : "base level",
+	           static_cast<double>(staged) / 1024.0,
+	           elapsed.count(),
+	           peakResidentSetSize(),
+	           peakResidentSetSize() - baseline);
+
+	return EXIT_SUCCESS;
+} catch (std::exception const& e) {
+	fmt::print(stderr, "{}\n", e.what());
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "ObjLoader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fmt/format.h>
+#include <functional>
+#include <glm/gtx/hash.hpp>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Compares MeshBuilder's flat table against the node-based map the loader used before, on the corners of an OBJ model or, without
+// arguments, on a synthetic grid whose coordinates collide badly under the old shift-xor hash.
+// usage: vertex_dedup_bench [model.obj] [repetitions]
+
+namespace
+{
+using namespace HelloTriangle;
+using Clock = std::chrono::steady_clock;
+
+auto legacyHash = [](Vertex const& vertex)
+{
+	auto const positionHash = std::hash<glm::vec3>{}(vertex.position);
+	auto const colourHash   = std::hash<glm::vec3>{}(vertex.colour);
+	auto const uvHash       = std::hash<glm::vec2>{}(vertex.texCoord);
+	return ((positionHash ^ (colourHash << 1)) >> 1) ^ (uvHash << 1);
+};
+
+auto legacyDeduplicate(std::span<Vertex const> const corners) -> VerticesAndIndices<std::uint32_t>
+{
+	auto result         = VerticesAndIndices<std::uint32_t>{};
+	auto uniqueVertices = std::unordered_map<Vertex, std::uint32_t, decltype(legacyHash)>{};
+
+	for (auto const& vertex : corners) {
+		if (!uniqueVertices.contains(vertex)) {
+			uniqueVertices[vertex] = static_cast<std::uint32_t>(result.vertices.size());
+			result.vertices.push_back(vertex);
+		}
+		result.vertexIndices.push_back(uniqueVertices[vertex]);
+	}
+
+	return result;
+}
+
+auto tableDeduplicate(std::span<Vertex const> const corners) -> VerticesAndIndices<std::uint32_t>
+{
+	auto builder = MeshBuilder{corners.size()};
+	for (auto const& vertex : corners) {
+		builder.addCorner(vertex);
+	}
+
+	return std::move(builder).finish();
+}
+
+// every quad of a size x size grid as two triangles, with integer positions and texture coordinates on a 1/size lattice
+auto makeGridCorners(std::uint32_t const size) -> std::vector<Vertex>
+{
+	auto const corner = [size](std::uint32_t const x, std::uint32_t const y)
+	{
+		auto const u = static_cast<float>(x) / static_cast<float>(size);
+		auto const v = static_cast<float>(y) / static_cast<float>(size);
+		return Vertex{{static_cast<float>(x), static_cast<float>(y), 0.0f}, glm::vec3{1.0f}, {u, v}};
+	};
+
+	auto corners = std::vector<Vertex>{};
+	corners.reserve(6u * size * size);
+	for (auto y = std::uint32_t{0}; y < size; ++y) {
+		for (auto x = std::uint32_t{0}; x < size; ++x) {
+			for (auto const& [dx, dy] : {std::pair{0u, 0u}, {1u, 0u}, {1u, 1u}, {0u, 0u}, {1u, 1u}, {0u, 1u}}) {
+				corners.push_back(corner(x + dx, y + dy));
+			}
+		}
+	}
+
+	return corners;
+}
+
+auto expandCorners(VerticesAndIndices<std::uint32_t> const& mesh) -> std::vector<Vertex>
+{
+	auto corners = std::vector<Vertex>{};
+	corners.reserve(mesh.vertexIndices.size());
+	std::ranges::transform(mesh.vertexIndices, std::back_inserter(corners), [&](auto const index) { return mesh.vertices.at(index); });
+
+	return corners;
+}
+
+// best of several runs, in milliseconds
+auto measure(std::span<Vertex const> const corners, unsigned const repetitions, auto const& deduplicate) -> double
+{
+	auto best = std::chrono::duration<double, std::milli>::max();
+	for (auto i = 0u; i < repetitions; ++i) {
+		auto const start  = Clock::now();
+		auto const result = deduplicate(corners);
+		best              = std::min<std::chrono::duration<double, std::milli>>(best, Clock::now() - start);
+
+		if (result.vertexIndices.size() != corners.size()) {
+			throw std::logic_error{"deduplication dropped corners"};
+		}
+	}
+
+	return best.count();
+}
+}// namespace
+
+auto main(int argc, char* argv[]) -> int
+try {
+	auto const corners     = argc > 1 ? expandCorners(loadObj(argv[1])) : makeGridCorners(1024u);
+	auto const repetitions = argc > 2 ? static_cast<unsigned>(std::max(std::atoi(argv[2]), 1)) : 5u;
+
+	auto const legacy = legacyDeduplicate(corners);
+	auto const table  = tableDeduplicate(corners);
+	if (legacy.vertices != table.vertices or legacy.vertexIndices != table.vertexIndices) {
+		throw std::logic_error{"the two implementations disagree"};
+	}
+
+	auto const legacyTime = measure(corners, repetitions, legacyDeduplicate);
+	auto const tableTime  = measure(corners, repetitions, tableDeduplicate);
+
+	fmt::print("{} corners, {} unique vertices, best of {}\n", corners.size(), table.vertices.size(), repetitions);
+	fmt::print("  unordered_map  {:9.2f} ms  {:7.1f} Mcorners/s\n", legacyTime, corners.size() / legacyTime / 1e3);
+	fmt::print("  open address   {:9.2f} ms  {:7.1f} Mcorners/s  ({:.2f}x)\n", tableTime, corners.size() / tableTime / 1e3, legacyTime / tableTime);
+
+	return EXIT_SUCCESS;
+} catch (std::exception const& e) {
+	fmt::print(stderr, "{}\n", e.what());
+	return EXIT_FAILURE;
+}
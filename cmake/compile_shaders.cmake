@@ -1,51 +1,100 @@
+# OPTIMISE runs spirv-opt -O over each module; EMBED also writes it as <name>.spv.hpp, holding a constexpr std::array of its
+# words named after the file (triangle.vert -> Shaders::TRIANGLE_VERT), in an include directory added to the target.
 function(compile_shaders TARGET_NAME)
-    set(OPTIONS HLSL GLSL INTERFACE PUBLIC PRIVATE)
+    set(OPTIONS HLSL GLSL INTERFACE PUBLIC PRIVATE OPTIMISE EMBED)
     set(MULTI_VALUE_KEYWORDS SHADER_FILES COMPILE_OPTIONS)
     cmake_parse_arguments(compile_shaders "${OPTIONS}" "${SINGLE_VALUE_KEYWORDS}" "${MULTI_VALUE_KEYWORDS}" ${ARGN})
 
     find_package(Vulkan REQUIRED)
 
+    if (compile_shaders_OPTIMISE)
+        # spirv-opt ships beside glslc in the SDK
+        get_filename_component(VULKAN_BIN_DIR "${Vulkan_GLSLC_EXECUTABLE}" DIRECTORY)
+        find_program(SPIRV_OPT_EXECUTABLE spirv-opt HINTS ${VULKAN_BIN_DIR} $ENV{VULKAN_SDK}/bin)
+        if (NOT SPIRV_OPT_EXECUTABLE)
+            message(FATAL_ERROR "spirv-opt not found.")
+        endif()
+    endif()
+    set(EMBED_DIR ${CMAKE_CURRENT_BINARY_DIR}/embedded_shaders)
+
     foreach(SHADER_FILE IN LISTS compile_shaders_SHADER_FILES)
         # get the filename and extension only
         cmake_path(GET SHADER_FILE FILENAME SHADER_FILE_NAME)
         # set the output file name
         set(SPIRV_FILE ${CMAKE_CURRENT_BINARY_DIR}/${SHADER_FILE_NAME}.spv)
-        
+        # the compiler writes here first when spirv-opt runs afterwards
+        if (compile_shaders_OPTIMISE)
+            set(COMPILER_OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${SHADER_FILE_NAME}.unoptimised.spv)
+        else()
+            set(COMPILER_OUTPUT ${SPIRV_FILE})
+        endif()
+
         # add the custom command to compile the shader
         if (compile_shaders_GLSL)
             if (NOT Vulkan_glslc_FOUND)
                 message(FATAL_ERROR "glslc not found.")
             endif()
-            set(COMPILE_COMMAND ${Vulkan_GLSLC_EXECUTABLE} ${compile_shaders_COMPILE_OPTIONS} -o ${SPIRV_FILE} ${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_FILE})
+            set(COMPILE_COMMAND ${Vulkan_GLSLC_EXECUTABLE} ${compile_shaders_COMPILE_OPTIONS} -o ${COMPILER_OUTPUT} ${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_FILE})
 
         elseif (compile_shaders_HLSL)
             if (NOT Vulkan_dxc_exe_FOUND)
                 message(FATAL_ERROR "dxc not found.")
             endif()
-        set(COMPILE_COMMAND ${Vulkan_dxc_EXECUTABLE} ${compile_shaders_COMPILE_OPTIONS} /T spirv /Fo ${SPIRV_FILE} ${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_FILE})
+        set(COMPILE_COMMAND ${Vulkan_dxc_EXECUTABLE} ${compile_shaders_COMPILE_OPTIONS} /T spirv /Fo ${COMPILER_OUTPUT} ${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_FILE})
 
         else()
             message(FATAL_ERROR "Unsupported shader language '${SHADER_LANGUAGE}'.")
         endif()
+        if (compile_shaders_OPTIMISE)
+            set(OPTIMISE_COMMAND COMMAND ${SPIRV_OPT_EXECUTABLE} -O ${COMPILER_OUTPUT} -o ${SPIRV_FILE})
+        else()
+            set(OPTIMISE_COMMAND)
+        endif()
         add_custom_command(
                 OUTPUT ${SPIRV_FILE}
                 COMMAND ${COMPILE_COMMAND}
+                ${OPTIMISE_COMMAND}
                 MAIN_DEPENDENCY ${SHADER_FILE}
         )
-        
+        set(SHADER_OUTPUTS ${SPIRV_FILE})
+
+        if (compile_shaders_EMBED)
+            string(MAKE_C_IDENTIFIER ${SHADER_FILE_NAME} SHADER_SYMBOL)
+            string(TOUPPER ${SHADER_SYMBOL} SHADER_SYMBOL)
+            set(HEADER_FILE ${EMBED_DIR}/${SHADER_FILE_NAME}.spv.hpp)
+            add_custom_command(
+                    OUTPUT ${HEADER_FILE}
+                    COMMAND ${CMAKE_COMMAND} -DINPUT=${SPIRV_FILE} -DOUTPUT=${HEADER_FILE} -DSYMBOL=${SHADER_SYMBOL}
+                            -P ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/embed_spirv.cmake
+                    DEPENDS ${SPIRV_FILE} ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/embed_spirv.cmake
+            )
+            list(APPEND SHADER_OUTPUTS ${HEADER_FILE})
+        endif()
+
+
         # add the output file to the target
         if (compile_shaders_INTERFACE)
-			target_sources(${TARGET_NAME} INTERFACE ${SPIRV_FILE})
+			target_sources(${TARGET_NAME} INTERFACE ${SHADER_OUTPUTS})
         elseif (compile_shaders_PUBLIC)
-            target_sources(${TARGET_NAME} PUBLIC ${SPIRV_FILE})
+            target_sources(${TARGET_NAME} PUBLIC ${SHADER_OUTPUTS})
         elseif (compile_shaders_PRIVATE)
-			target_sources(${TARGET_NAME} PRIVATE ${SPIRV_FILE})
+			target_sources(${TARGET_NAME} PRIVATE ${SHADER_OUTPUTS})
         endif()
     endforeach()
+
+    if (compile_shaders_EMBED)
+        if (compile_shaders_INTERFACE)
+            target_include_directories(${TARGET_NAME} INTERFACE ${EMBED_DIR})
+        elseif (compile_shaders_PUBLIC)
+            target_include_directories(${TARGET_NAME} PUBLIC ${EMBED_DIR})
+        elseif (compile_shaders_PRIVATE)
+            target_include_directories(${TARGET_NAME} PRIVATE ${EMBED_DIR})
+        endif()
+    endif()
 endfunction()
 
 function(target_shaders TARGET_NAME)
-    set(OPTIONS HLSL GLSL)
+    set(OPTIONS HLSL GLSL OPTIMISE EMBED)
     set(SINGLE_VALUE_KEYWORDS)
     set(MULTI_VALUE_KEYWORDS INTERFACE PUBLIC PRIVATE COMPILE_OPTIONS)
     cmake_parse_arguments(target_shaders "${OPTIONS}" "${SINGLE_VALUE_KEYWORDS}" "${MULTI_VALUE_KEYWORDS}" ${ARGN})
@@ -57,12 +106,19 @@ function(target_shaders TARGET_NAME)
 	else()
 		message(FATAL_ERROR "No shader language specified.")
     endif()
+    set(SHADER_FLAGS)
+    if (target_shaders_OPTIMISE)
+        list(APPEND SHADER_FLAGS OPTIMISE)
+    endif()
+    if (target_shaders_EMBED)
+        list(APPEND SHADER_FLAGS EMBED)
+    endif()
 
     if (target_shaders_INTERFACE)
-        compile_shaders(${TARGET_NAME} INTERFACE ${SHADER_LANGUAGE} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_INTERFACE})
+        compile_shaders(${TARGET_NAME} INTERFACE ${SHADER_LANGUAGE} ${SHADER_FLAGS} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_INTERFACE})
     elseif(target_shaders_PUBLIC)
-        compile_shaders(${TARGET_NAME} PUBLIC ${SHADER_LANGUAGE} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_PUBLIC})
+        compile_shaders(${TARGET_NAME} PUBLIC ${SHADER_LANGUAGE} ${SHADER_FLAGS} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_PUBLIC})
     elseif(target_shaders_PRIVATE)
-        compile_shaders(${TARGET_NAME} PRIVATE ${SHADER_LANGUAGE} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_PRIVATE})
+        compile_shaders(${TARGET_NAME} PRIVATE ${SHADER_LANGUAGE} ${SHADER_FLAGS} COMPILE_OPTIONS ${target_shaders_COMPILE_OPTIONS} SHADER_FILES ${target_shaders_PRIVATE})
     endif()
 endfunction()
\ No newline at end of file
@@ -0,0 +1,31 @@
+# Writes a SPIR-V binary as a header holding a constexpr std::array of its words.
+# usage: cmake -DINPUT=<file.spv> -DOUTPUT=<file.hpp> -DSYMBOL=<NAME> -P embed_spirv.cmake
+
+file(READ ${INPUT} SPIRV_HEX HEX)
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_BYTES "${SPIRV_HEX_LENGTH} / 2")
+math(EXPR SPIRV_REMAINDER "${SPIRV_BYTES} % 4")
+if (SPIRV_BYTES EQUAL 0 OR NOT SPIRV_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V binary (${SPIRV_BYTES} bytes).")
+endif()
+math(EXPR SPIRV_WORDS "${SPIRV_BYTES} / 4")
+
+# SPIR-V words are little-endian in the file
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " SPIRV_WORD_LIST "${SPIRV_HEX}")
+# eight words to a line
+string(REPEAT "0x[0-9a-f]+u, " 8 SPIRV_LINE_PATTERN)
+string(REGEX REPLACE "(${SPIRV_LINE_PATTERN})" "\\1\n\t" SPIRV_WORD_LIST "${SPIRV_WORD_LIST}")
+
+file(WRITE ${OUTPUT} "#pragma once
+
+// generated from ${INPUT}; do not edit
+
+#include <array>
+#include <cstdint>
+
+namespace Shaders
+{
+inline constexpr auto ${SYMBOL} = std::array<std::uint32_t, ${SPIRV_WORDS}>{
+\t${SPIRV_WORD_LIST}};
+}// namespace Shaders
+")
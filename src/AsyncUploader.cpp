@@ -0,0 +1,86 @@
+#include "AsyncUploader.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto makeTimelineSemaphore(vkr::Device const& device) -> vkr::Semaphore
+{
+	auto const semaphoreInfo =
+	    vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo>{{}, vk::SemaphoreTypeCreateInfo{vk::SemaphoreType::eTimeline, 0u}};
+
+	return device.createSemaphore(semaphoreInfo.get<vk::SemaphoreCreateInfo>());
+}
+}// namespace
+
+AsyncUploader::AsyncUploader(vkr::Device const&  logicalDevice,
+                             DeviceAllocator&    deviceAllocator,
+                             vkr::Queue const&   transferQueue,
+                             std::uint32_t const queueFamily,
+                             std::uint32_t const consumerFamily)
+    : device{logicalDevice},
+      allocator{deviceAllocator},
+      queue{transferQueue},
+      ownership{queueFamily == consumerFamily ? QueueFamilyTransfer{} : QueueFamilyTransfer{queueFamily, consumerFamily}},
+      commandPool{logicalDevice.createCommandPool(vk::CommandPoolCreateInfo{vk::CommandPoolCreateFlagBits::eTransient, queueFamily})},
+      timeline{makeTimelineSemaphore(logicalDevice)}
+{}
+
+AsyncUploader::~AsyncUploader() = default;
+
+auto AsyncUploader::makeBatch() const -> std::unique_ptr<UploadBatch>
+{
+	return std::make_unique<UploadBatch>(device, commandPool, allocator, ownership);
+}
+
+auto AsyncUploader::submit(std::unique_ptr<UploadBatch> batch) -> std::uint64_t
+{
+	auto const value = nextValue++;
+	batch->submit(queue, *timeline, value);
+	inFlight.push_back({value, std::move(batch)});
+
+	return value;
+}
+
+auto AsyncUploader::isComplete(std::uint64_t const value) const -> bool { return timeline.getCounterValue() >= value; }
+
+auto AsyncUploader::wait(std::uint64_t const value) const -> void
+{
+	auto const semaphore = *timeline;
+	if (device.waitSemaphores(vk::SemaphoreWaitInfo{{}, semaphore, value}, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) {
+		throw std::runtime_error{"failed to wait for upload timeline semaphore"};
+	}
+}
+
+auto AsyncUploader::acquire(std::uint64_t const value, vkr::CommandBuffer const& commandBuffer) -> void
+{
+	auto const it = std::ranges::find(inFlight, value, &InFlightBatch::value);
+	if (it == std::end(inFlight) or it->acquired) {
+		throw std::logic_error{"upload batch is not awaiting acquisition"};
+	}
+
+	it->batch->recordAcquire(commandBuffer);
+	it->acquired = true;
+}
+
+auto AsyncUploader::collect() -> void
+{
+	if (inFlight.empty()) {
+		return;
+	}
+
+	auto const completedValue = timeline.getCounterValue();
+	for (auto& entry : inFlight) {
+		if (entry.value <= completedValue) {
+			entry.batch->releaseIfComplete();
+		}
+	}
+
+	std::erase_if(inFlight, [](auto const& entry) { return entry.acquired and entry.batch->complete(); });
+}
+}// namespace HelloTriangle
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "DeviceAllocator.hpp"
+#include "UploadBatch.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// Streams upload batches through the transfer queue without blocking the caller. Each submission signals the next value of a
+// timeline semaphore; the consumer polls the counter and, once a value is reached, records the batch's acquire barriers into a
+// command buffer whose submission waits on that same value.
+class AsyncUploader
+{
+public:
+	// the queue belongs to queueFamily; consumerFamily is the queue family that uses the uploaded resources
+	AsyncUploader(vkr::Device const&, DeviceAllocator&, vkr::Queue const&, std::uint32_t queueFamily, std::uint32_t consumerFamily);
+	AsyncUploader(AsyncUploader const&)                    = delete;
+	auto operator=(AsyncUploader const&) -> AsyncUploader& = delete;
+	~AsyncUploader();
+
+	[[nodiscard]] auto makeBatch() const -> std::unique_ptr<UploadBatch>;
+	// returns the timeline value the batch signals on completion
+	auto               submit(std::unique_ptr<UploadBatch>) -> std::uint64_t;
+
+	[[nodiscard]] auto semaphore() const -> vk::Semaphore { return *timeline; }
+	[[nodiscard]] auto isComplete(std::uint64_t) const -> bool;
+	auto               wait(std::uint64_t) const -> void;
+	// record the acquire barriers for a completed batch; its resources are then owned by the destination queue family
+	auto               acquire(std::uint64_t, vkr::CommandBuffer const&) -> void;
+	// free every batch that has both completed and been acquired
+	auto               collect() -> void;
+
+private:
+	struct InFlightBatch
+	{
+		std::uint64_t                value{};
+		std::unique_ptr<UploadBatch> batch;
+		bool                         acquired{};
+	};
+
+	vkr::Device const&        device;
+	DeviceAllocator&          allocator;
+	vkr::Queue const&         queue;
+	QueueFamilyTransfer const ownership;
+	vkr::CommandPool          commandPool;
+	vkr::Semaphore            timeline;
+	std::uint64_t             nextValue{1u};
+	std::deque<InFlightBatch> inFlight{};
+};
+}// namespace HelloTriangle
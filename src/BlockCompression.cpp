@@ -0,0 +1,395 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+constexpr auto CHANNELS     = std::size_t{4u};
+constexpr auto BLOCK_EXTENT = std::uint32_t{4u};
+constexpr auto BLOCK_TEXELS = std::size_t{BLOCK_EXTENT * BLOCK_EXTENT};
+
+using Texel = std::array<float, CHANNELS>;
+using Block = std::array<Texel, BLOCK_TEXELS>;
+
+auto loadBlock(std::uint8_t const* const texels,
+               std::uint32_t const       width,
+               std::uint32_t const       height,
+               std::uint32_t const       blockX,
+               std::uint32_t const       blockY) -> Block
+{
+	auto block = Block{};
+	for (auto y = std::uint32_t{0}; y < BLOCK_EXTENT; ++y) {
+		for (auto x = std::uint32_t{0}; x < BLOCK_EXTENT; ++x) {
+			auto const sourceX = std::min(blockX * BLOCK_EXTENT + x, width - 1u);
+			auto const sourceY = std::min(blockY * BLOCK_EXTENT + y, height - 1u);
+			auto const source  = texels + (std::size_t{sourceY} * width + sourceX) * CHANNELS;
+			std::ranges::transform(
+			    source, source + CHANNELS, std::begin(block[y * BLOCK_EXTENT + x]), [](auto const value) { return static_cast<float>(value); });
+		}
+	}
+
+	return block;
+}
+
+// the ends of the block's extent along its principal axis over the first Channels channels; the others are copied from the mean
+template<std::size_t Channels>
+auto principalEndpoints(Block const& block) -> std::pair<Texel, Texel>
+{
+	auto mean = Texel{};
+	for (auto const& texel : block) {
+		for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+			mean[c] += texel[c] / static_cast<float>(BLOCK_TEXELS);
+		}
+	}
+
+	auto covariance = std::array<std::array<float, Channels>, Channels>{};
+	for (auto const& texel : block) {
+		for (auto i = std::size_t{0}; i < Channels; ++i) {
+			for (auto j = std::size_t{0}; j < Channels; ++j) {
+				covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+			}
+		}
+	}
+
+	// power iteration converges quickly enough for endpoint selection
+	auto axis = std::array<float, Channels>{};
+	axis.fill(1.0f);
+	for (auto iteration = 0; iteration < 8; ++iteration) {
+		auto next = std::array<float, Channels>{};
+		for (auto i = std::size_t{0}; i < Channels; ++i) {
+			for (auto j = std::size_t{0}; j < Channels; ++j) {
+				next[i] += covariance[i][j] * axis[j];
+			}
+		}
+		auto const length = std::sqrt(std::inner_product(std::begin(next), std::end(next), std::begin(next), 0.0f));
+		if (length < std::numeric_limits<float>::epsilon()) {
+			return {mean, mean};
+		}
+		std::ranges::transform(next, std::begin(axis), [length](auto const value) { return value / length; });
+	}
+
+	auto lowest  = std::numeric_limits<float>::max();
+	auto highest = std::numeric_limits<float>::lowest();
+	for (auto const& texel : block) {
+		auto projection = 0.0f;
+		for (auto c = std::size_t{0}; c < Channels; ++c) {
+			projection += (texel[c] - mean[c]) * axis[c];
+		}
+		lowest  = std::min(lowest, projection);
+		highest = std::max(highest, projection);
+	}
+
+	auto low  = mean;
+	auto high = mean;
+	for (auto c = std::size_t{0}; c < Channels; ++c) {
+		low[c]  = std::clamp(mean[c] + axis[c] * lowest, 0.0f, 255.0f);
+		high[c] = std::clamp(mean[c] + axis[c] * highest, 0.0f, 255.0f);
+	}
+
+	return {low, high};
+}
+
+// endpoints that minimise the squared error for fixed interpolation weights, or nothing if every weight is the same
+auto leastSquaresEndpoints(Block const& block, std::span<float const, BLOCK_TEXELS> const weights) -> std::optional<std::pair<Texel, Texel>>
+{
+	auto aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	auto ax = Texel{}, bx = Texel{};
+	for (auto i = std::size_t{0}; i < BLOCK_TEXELS; ++i) {
+		auto const b = weights[i];
+		auto const a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+			ax[c] += a * block[i][c];
+			bx[c] += b * block[i][c];
+		}
+	}
+
+	auto const determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < std::numeric_limits<float>::epsilon()) {
+		return {};
+	}
+
+	auto low = Texel{}, high = Texel{};
+	for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+		low[c]  = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+		high[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+	}
+
+	return std::pair{low, high};
+}
+
+template<std::size_t Channels, std::size_t Entries>
+auto squaredDistance(Texel const& texel, std::array<Texel, Entries> const& palette, std::size_t const entry) -> float
+{
+	auto distance = 0.0f;
+	for (auto c = std::size_t{0}; c < Channels; ++c) {
+		auto const delta = texel[c] - palette[entry][c];
+		distance += delta * delta;
+	}
+	return distance;
+}
+
+// nearest palette entry for every texel, and the total squared error
+template<std::size_t Channels, std::size_t Entries>
+auto selectIndices(Block const& block, std::array<Texel, Entries> const& palette) -> std::pair<std::array<std::uint8_t, BLOCK_TEXELS>, float>
+{
+	auto indices = std::array<std::uint8_t, BLOCK_TEXELS>{};
+	auto error   = 0.0f;
+	for (auto i = std::size_t{0}; i < BLOCK_TEXELS; ++i) {
+		auto best = std::numeric_limits<float>::max();
+		for (auto entry = std::size_t{0}; entry < Entries; ++entry) {
+			if (auto const distance = squaredDistance<Channels>(block[i], palette, entry); distance < best) {
+				best       = distance;
+				indices[i] = static_cast<std::uint8_t>(entry);
+			}
+		}
+		error += best;
+	}
+
+	return {indices, error};
+}
+
+// little-endian bit packing, lowest bit first
+template<std::size_t Bytes>
+struct BitWriter
+{
+	std::array<std::byte, Bytes> bytes{};
+	std::size_t                  position{};
+
+	auto write(std::uint32_t const value, std::size_t const bits) -> void
+	{
+		for (auto bit = std::size_t{0}; bit < bits; ++bit, ++position) {
+			bytes[position / 8u] |= static_cast<std::byte>(((value >> bit) & 1u) << (position % 8u));
+		}
+	}
+};
+
+// BC1
+
+struct Bc1Candidate
+{
+	std::uint16_t                          colour0{};
+	std::uint16_t                          colour1{};
+	std::array<std::uint8_t, BLOCK_TEXELS> indices{};
+	float                                  error{std::numeric_limits<float>::max()};
+};
+
+constexpr auto BC1_WEIGHTS = std::array{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+auto toRgb565(Texel const& colour) -> std::uint16_t
+{
+	auto const quantise = [&](std::size_t const c, float const levels)
+	{ return static_cast<std::uint32_t>(std::lround(colour[c] * levels / 255.0f)); };
+	return static_cast<std::uint16_t>(quantise(0u, 31.0f) << 11u | quantise(1u, 63.0f) << 5u | quantise(2u, 31.0f));
+}
+
+auto fromRgb565(std::uint16_t const colour) -> Texel
+{
+	auto const red   = colour >> 11u & 0x1Fu;
+	auto const green = colour >> 5u & 0x3Fu;
+	auto const blue  = colour & 0x1Fu;
+	return {static_cast<float>(red << 3u | red >> 2u),
+	        static_cast<float>(green << 2u | green >> 4u),
+	        static_cast<float>(blue << 3u | blue >> 2u),
+	        255.0f};
+}
+
+auto evaluateBc1(Block const& block, Texel const& endpoint0, Texel const& endpoint1) -> Bc1Candidate
+{
+	auto colour0 = toRgb565(endpoint0);
+	auto colour1 = toRgb565(endpoint1);
+	// colour0 > colour1 selects the four-colour mode; equal endpoints fall back to three colours, where index 0 is still correct
+	if (colour0 < colour1) {
+		std::swap(colour0, colour1);
+	}
+
+	auto const first   = fromRgb565(colour0);
+	auto const second  = fromRgb565(colour1);
+	auto       palette = std::array<Texel, 4>{};
+	for (auto entry = std::size_t{0}; entry < palette.size(); ++entry) {
+		for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+			palette[entry][c] = first[c] + (second[c] - first[c]) * BC1_WEIGHTS[entry];
+		}
+	}
+
+	if (colour0 == colour1) {
+		auto const [indices, error] = selectIndices<3u>(block, std::array<Texel, 1>{palette[0]});
+		return {colour0, colour1, indices, error};
+	}
+
+	auto const [indices, error] = selectIndices<3u>(block, palette);
+	return {colour0, colour1, indices, error};
+}
+
+auto encodeBc1Block(Block const& block) -> std::array<std::byte, 8>
+{
+	auto const [low, high] = principalEndpoints<3u>(block);
+	auto best              = evaluateBc1(block, low, high);
+
+	for (auto iteration = 0; iteration < 2; ++iteration) {
+		auto weights = std::array<float, BLOCK_TEXELS>{};
+		std::ranges::transform(best.indices, std::begin(weights), [](auto const index) { return BC1_WEIGHTS[index]; });
+
+		auto const refined = leastSquaresEndpoints(block, weights);
+		if (not refined) {
+			break;
+		}
+		if (auto candidate = evaluateBc1(block, refined->first, refined->second); candidate.error < best.error) {
+			best = candidate;
+		} else {
+			break;
+		}
+	}
+
+	auto writer = BitWriter<8>{};
+	writer.write(best.colour0, 16u);
+	writer.write(best.colour1, 16u);
+	for (auto const index : best.indices) {
+		writer.write(index, 2u);
+	}
+
+	return writer.bytes;
+}
+
+// BC7 mode 6
+
+struct Bc7Candidate
+{
+	std::array<std::uint32_t, CHANNELS>    endpoint0{};
+	std::array<std::uint32_t, CHANNELS>    endpoint1{};
+	std::uint32_t                          pBit0{};
+	std::uint32_t                          pBit1{};
+	std::array<std::uint8_t, BLOCK_TEXELS> indices{};
+	float                                  error{std::numeric_limits<float>::max()};
+};
+
+constexpr auto BC7_WEIGHTS = std::array{0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+// the 7-bit value nearest to the endpoint once the shared bit is appended
+auto quantiseMode6(Texel const& endpoint, std::uint32_t const pBit) -> std::array<std::uint32_t, CHANNELS>
+{
+	auto quantised = std::array<std::uint32_t, CHANNELS>{};
+	std::ranges::transform(endpoint,
+	                       std::begin(quantised),
+	                       [pBit](auto const value)
+	                       { return static_cast<std::uint32_t>(std::clamp(std::lround((value - static_cast<float>(pBit)) / 2.0f), 0L, 127L)); });
+	return quantised;
+}
+
+auto evaluateBc7(Block const& block, Texel const& low, Texel const& high) -> Bc7Candidate
+{
+	auto best = Bc7Candidate{};
+	for (auto pBit0 = 0u; pBit0 < 2u; ++pBit0) {
+		for (auto pBit1 = 0u; pBit1 < 2u; ++pBit1) {
+			auto const endpoint0 = quantiseMode6(low, pBit0);
+			auto const endpoint1 = quantiseMode6(high, pBit1);
+
+			auto palette = std::array<Texel, BC7_WEIGHTS.size()>{};
+			for (auto entry = std::size_t{0}; entry < palette.size(); ++entry) {
+				for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+					auto const first  = endpoint0[c] << 1u | pBit0;
+					auto const second = endpoint1[c] << 1u | pBit1;
+					palette[entry][c] = static_cast<float>(((64u - BC7_WEIGHTS[entry]) * first + BC7_WEIGHTS[entry] * second + 32u) >> 6u);
+				}
+			}
+
+			if (auto const [indices, error] = selectIndices<CHANNELS>(block, palette); error < best.error) {
+				best = {endpoint0, endpoint1, pBit0, pBit1, indices, error};
+			}
+		}
+	}
+
+	return best;
+}
+
+auto encodeBc7Block(Block const& block) -> std::array<std::byte, 16>
+{
+	auto const [low, high] = principalEndpoints<CHANNELS>(block);
+	auto best              = evaluateBc7(block, low, high);
+
+	for (auto iteration = 0; iteration < 2; ++iteration) {
+		auto weights = std::array<float, BLOCK_TEXELS>{};
+		std::ranges::transform(best.indices, std::begin(weights), [](auto const index) { return static_cast<float>(BC7_WEIGHTS[index]) / 64.0f; });
+
+		auto const refined = leastSquaresEndpoints(block, weights);
+		if (not refined) {
+			break;
+		}
+		if (auto candidate = evaluateBc7(block, refined->first, refined->second); candidate.error < best.error) {
+			best = candidate;
+		} else {
+			break;
+		}
+	}
+
+	// the first texel's index is stored without its top bit, so it must be below 8
+	if (best.indices.front() >= 8u) {
+		std::swap(best.endpoint0, best.endpoint1);
+		std::swap(best.pBit0, best.pBit1);
+		std::ranges::transform(best.indices, std::begin(best.indices), [](auto const index) { return static_cast<std::uint8_t>(15u - index); });
+	}
+
+	auto writer = BitWriter<16>{};
+	writer.write(1u << 6u, 7u);
+	for (auto c = std::size_t{0}; c < CHANNELS; ++c) {
+		writer.write(best.endpoint0[c], 7u);
+		writer.write(best.endpoint1[c], 7u);
+	}
+	writer.write(best.pBit0, 1u);
+	writer.write(best.pBit1, 1u);
+	writer.write(best.indices.front(), 3u);
+	for (auto i = std::size_t{1}; i < BLOCK_TEXELS; ++i) {
+		writer.write(best.indices[i], 4u);
+	}
+
+	return writer.bytes;
+}
+
+template<std::size_t BlockBytes>
+auto encodeBlocks(std::span<std::byte const> const rgba,
+                  std::uint32_t const              width,
+                  std::uint32_t const              height,
+                  auto const&                      encodeBlock) -> std::vector<std::byte>
+{
+	if (width == 0u or height == 0u or rgba.size() != std::size_t{width} * height * CHANNELS) {
+		throw std::invalid_argument{"texel data does not match the image extent"};
+	}
+
+	auto const blocksWide = (width + BLOCK_EXTENT - 1u) / BLOCK_EXTENT;
+	auto const blocksHigh = (height + BLOCK_EXTENT - 1u) / BLOCK_EXTENT;
+	auto const texels     = reinterpret_cast<std::uint8_t const*>(rgba.data());
+
+	auto blocks = std::vector<std::byte>(std::size_t{blocksWide} * blocksHigh * BlockBytes);
+	for (auto blockY = std::uint32_t{0}; blockY < blocksHigh; ++blockY) {
+		for (auto blockX = std::uint32_t{0}; blockX < blocksWide; ++blockX) {
+			auto const encoded = encodeBlock(loadBlock(texels, width, height, blockX, blockY));
+			std::ranges::copy(encoded, std::begin(blocks) + static_cast<std::ptrdiff_t>((std::size_t{blockY} * blocksWide + blockX) * BlockBytes));
+		}
+	}
+
+	return blocks;
+}
+}// namespace
+
+auto encodeBc1(std::span<std::byte const> const rgba, std::uint32_t const width, std::uint32_t const height) -> std::vector<std::byte>
+{
+	return encodeBlocks<8u>(rgba, width, height, encodeBc1Block);
+}
+
+auto encodeBc7(std::span<std::byte const> const rgba, std::uint32_t const width, std::uint32_t const height) -> std::vector<std::byte>
+{
+	return encodeBlocks<16u>(rgba, width, height, encodeBc7Block);
+}
+}// namespace HelloTriangle
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace HelloTriangle
+{
+// Offline encoders from 8-bit RGBA texels to 4x4 blocks, row-major, with partial blocks at the right and bottom edges padded by
+// repeating the edge texels. Both work on the stored values, so sRGB input gives blocks for the matching sRGB format.
+
+// BC1 (8 bytes a block): opaque colour as two RGB565 endpoints and four interpolated colours; alpha is ignored
+[[nodiscard]] auto encodeBc1(std::span<std::byte const> rgba, std::uint32_t width, std::uint32_t height) -> std::vector<std::byte>;
+
+// BC7 (16 bytes a block) in mode 6 only: one RGBA endpoint pair at 7 bits plus a shared-LSB bit per endpoint, with 16 interpolated
+// values; quality is well above BC1, and alpha is kept
+[[nodiscard]] auto encodeBc7(std::span<std::byte const> rgba, std::uint32_t width, std::uint32_t height) -> std::vector<std::byte>;
+}// namespace HelloTriangle
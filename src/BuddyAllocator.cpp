@@ -0,0 +1,88 @@
+#include "BuddyAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto orderCount(std::uint64_t const capacity, std::uint64_t const minBlockSize) -> std::uint32_t
+{
+	if (not std::has_single_bit(capacity) or not std::has_single_bit(minBlockSize) or minBlockSize > capacity) {
+		throw std::invalid_argument{"buddy allocator capacity and minimum block size must be powers of two"};
+	}
+
+	return static_cast<std::uint32_t>(std::countr_zero(capacity) - std::countr_zero(minBlockSize));
+}
+}// namespace
+
+BuddyAllocator::BuddyAllocator(std::uint64_t const capacity, std::uint64_t const minBlock)
+    : minBlockSize{minBlock},
+      maxOrder{orderCount(capacity, minBlock)},
+      freeLists(maxOrder + 1u)
+{
+	freeLists.at(maxOrder).insert(0u);
+}
+
+auto BuddyAllocator::orderFor(std::uint64_t const size) const -> std::optional<std::uint32_t>
+{
+	if (size > capacity()) {
+		return {};
+	}
+
+	auto const roundedSize = std::bit_ceil(std::max(size, minBlockSize));
+	return static_cast<std::uint32_t>(std::countr_zero(roundedSize) - std::countr_zero(minBlockSize));
+}
+
+auto BuddyAllocator::allocate(std::uint64_t const size, std::uint64_t const alignment) -> std::optional<Allocation>
+{
+	// every block is aligned to its own size, so rounding up to the alignment is enough to satisfy it
+	auto const order = orderFor(std::max(size, alignment));
+	if (not order.has_value()) {
+		return {};
+	}
+
+	auto sourceOrder = *order;
+	while (sourceOrder <= maxOrder and freeLists.at(sourceOrder).empty()) {
+		++sourceOrder;
+	}
+	if (sourceOrder > maxOrder) {
+		return {};
+	}
+
+	auto&      sourceList = freeLists.at(sourceOrder);
+	auto const offset     = *std::begin(sourceList);
+	sourceList.erase(std::begin(sourceList));
+
+	// split down, returning the upper halves to the free lists
+	while (sourceOrder > *order) {
+		--sourceOrder;
+		freeLists.at(sourceOrder).insert(offset + blockSize(sourceOrder));
+	}
+
+	usedBytes += blockSize(*order);
+
+	return Allocation{offset, *order};
+}
+
+auto BuddyAllocator::free(Allocation const& allocation) -> void
+{
+	auto offset = allocation.offset;
+	auto order  = allocation.order;
+	usedBytes -= blockSize(order);
+
+	// merge with free buddies for as long as they exist
+	while (order < maxOrder) {
+		auto const buddy = offset ^ blockSize(order);
+		if (freeLists.at(order).erase(buddy) == 0u) {
+			break;
+		}
+		offset = std::min(offset, buddy);
+		++order;
+	}
+
+	freeLists.at(order).insert(offset);
+}
+}// namespace HelloTriangle
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace HelloTriangle
+{
+// Power-of-two buddy allocator over an abstract address range; it hands out offsets and never touches memory itself.
+class BuddyAllocator
+{
+public:
+	struct Allocation
+	{
+		std::uint64_t offset{};
+		std::uint32_t order{};
+	};
+
+	BuddyAllocator(std::uint64_t capacity, std::uint64_t minBlockSize);
+
+	[[nodiscard]] auto allocate(std::uint64_t size, std::uint64_t alignment) -> std::optional<Allocation>;
+	auto               free(Allocation const&) -> void;
+
+	[[nodiscard]] auto capacity() const -> std::uint64_t { return blockSize(maxOrder); }
+	[[nodiscard]] auto used() const -> std::uint64_t { return usedBytes; }
+	[[nodiscard]] auto empty() const -> bool { return usedBytes == 0u; }
+	[[nodiscard]] auto blockSize(std::uint32_t const order) const -> std::uint64_t { return minBlockSize << order; }
+
+private:
+	std::uint64_t                        minBlockSize;
+	std::uint32_t                        maxOrder;
+	std::uint64_t                        usedBytes{};
+	std::vector<std::set<std::uint64_t>> freeLists;
+
+	[[nodiscard]] auto orderFor(std::uint64_t size) const -> std::optional<std::uint32_t>;
+};
+}// namespace HelloTriangle
@@ -0,0 +1,252 @@
+#include "DeviceAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace rv = std::ranges::views;
+
+namespace
+{
+constexpr auto DEFAULT_BLOCK_SIZE = vk::DeviceSize{64u << 20u};
+constexpr auto RESOURCE_KIND_COUNT = static_cast<std::uint32_t>(ResourceKind::Count);
+
+auto makeBlockSizes(vk::PhysicalDeviceMemoryProperties const& memoryProperties) -> std::vector<vk::DeviceSize>
+{
+	auto blockSizes = std::vector<vk::DeviceSize>{};
+	blockSizes.reserve(memoryProperties.memoryTypeCount);
+
+	// small heaps (e.g. 256 MiB BAR windows) get smaller blocks so that one block cannot claim a large share of the heap
+	std::ranges::transform(rv::iota(0u, memoryProperties.memoryTypeCount),
+	                       std::back_inserter(blockSizes),
+	                       [&](auto const i)
+	                       {
+		                       auto const heapSize = memoryProperties.memoryHeaps.at(memoryProperties.memoryTypes.at(i).heapIndex).size;
+		                       return std::clamp(std::bit_floor(heapSize / 8u), DeviceAllocator::MIN_BLOCK_SIZE, DEFAULT_BLOCK_SIZE);
+	                       });
+
+	return blockSizes;
+}
+
+auto isHostVisible(vk::PhysicalDeviceMemoryProperties const& memoryProperties, std::uint32_t const memoryTypeIndex) -> bool
+{
+	return static_cast<bool>(memoryProperties.memoryTypes.at(memoryTypeIndex).propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+}
+}// namespace
+
+DeviceAllocation::DeviceAllocation(DeviceAllocation&& other) noexcept
+    : allocator{std::exchange(other.allocator, nullptr)},
+      block{std::exchange(other.block, nullptr)},
+      range{other.range},
+      dedicatedMemory{std::move(other.dedicatedMemory)},
+      deviceMemory{std::exchange(other.deviceMemory, nullptr)},
+      memoryOffset{std::exchange(other.memoryOffset, 0u)},
+      allocationSize{std::exchange(other.allocationSize, 0u)},
+      mapped{std::exchange(other.mapped, nullptr)}
+{}
+
+auto DeviceAllocation::operator=(DeviceAllocation&& other) noexcept -> DeviceAllocation&
+{
+	if (this != &other) {
+		release();
+		allocator       = std::exchange(other.allocator, nullptr);
+		block           = std::exchange(other.block, nullptr);
+		range           = other.range;
+		dedicatedMemory = std::move(other.dedicatedMemory);
+		deviceMemory    = std::exchange(other.deviceMemory, nullptr);
+		memoryOffset    = std::exchange(other.memoryOffset, 0u);
+		allocationSize  = std::exchange(other.allocationSize, 0u);
+		mapped          = std::exchange(other.mapped, nullptr);
+	}
+
+	return *this;
+}
+
+DeviceAllocation::~DeviceAllocation() { release(); }
+
+auto DeviceAllocation::release() -> void
+{
+	if (allocator != nullptr) {
+		allocator->free(*this);
+		allocator = nullptr;
+	}
+	dedicatedMemory.clear();
+	block        = nullptr;
+	deviceMemory = nullptr;
+	mapped       = nullptr;
+}
+
+DeviceAllocator::DeviceAllocator(vkr::Device const& logicalDevice, vkr::PhysicalDevice const& physicalDevice)
+    : device{logicalDevice},
+      memoryProperties{physicalDevice.getMemoryProperties()},
+      blockSizes{makeBlockSizes(memoryProperties)},
+      pools(memoryProperties.memoryTypeCount * RESOURCE_KIND_COUNT)
+{}
+
+DeviceAllocator::~DeviceAllocator() = default;
+
+auto DeviceAllocator::findMemoryType(std::uint32_t const typeFilter, vk::MemoryPropertyFlags const& flags) const -> std::uint32_t
+{
+	for (auto const i : rv::iota(0u, memoryProperties.memoryTypeCount)) {
+		if (typeFilter & (1u << i) and (memoryProperties.memoryTypes.at(i).propertyFlags & flags) == flags) {
+			return i;
+		}
+	}
+
+	throw std::runtime_error("failed to find suitable memory type");
+}
+
+// whether findMemoryType would succeed; a type the resource cannot live in does not count, however good its properties
+auto DeviceAllocator::hasMemoryType(std::uint32_t const typeFilter, vk::MemoryPropertyFlags const& flags) const -> bool
+{
+	return std::ranges::any_of(rv::iota(0u, memoryProperties.memoryTypeCount), [&](auto const i) {
+		return typeFilter & (1u << i) and (memoryProperties.memoryTypes.at(i).propertyFlags & flags) == flags;
+	});
+}
+
+auto DeviceAllocator::allocateFor(vkr::Buffer const& buffer, vk::MemoryPropertyFlags const& properties) -> DeviceAllocation
+{
+	auto const requirements =
+	    device.getBufferMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(vk::BufferMemoryRequirementsInfo2{*buffer});
+	auto const& memoryRequirements    = requirements.get<vk::MemoryRequirements2>().memoryRequirements;
+	auto const& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+	auto const  prefersDedicated =
+	    dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE or dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE;
+
+	auto allocation =
+	    allocate(memoryRequirements, properties, ResourceKind::Linear, prefersDedicated, vk::MemoryDedicatedAllocateInfo{{}, *buffer});
+	buffer.bindMemory(allocation.memory(), allocation.offset());
+
+	return allocation;
+}
+
+auto DeviceAllocator::allocateFor(vkr::Image const& image, vk::ImageTiling const& tiling, vk::MemoryPropertyFlags const& properties)
+    -> DeviceAllocation
+{
+	auto const requirements =
+	    device.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(vk::ImageMemoryRequirementsInfo2{*image});
+	auto const& memoryRequirements    = requirements.get<vk::MemoryRequirements2>().memoryRequirements;
+	auto const& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+	auto const  prefersDedicated =
+	    dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE or dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE;
+	auto const kind = tiling == vk::ImageTiling::eOptimal ? ResourceKind::Optimal : ResourceKind::Linear;
+
+	auto allocation = allocate(memoryRequirements, properties, kind, prefersDedicated, vk::MemoryDedicatedAllocateInfo{*image});
+	image.bindMemory(allocation.memory(), allocation.offset());
+
+	return allocation;
+}
+
+auto DeviceAllocator::allocate(vk::MemoryRequirements const&          requirements,
+                               vk::MemoryPropertyFlags const&         properties,
+                               ResourceKind const                     kind,
+                               bool const                             prefersDedicated,
+                               vk::MemoryDedicatedAllocateInfo const& dedicatedInfo) -> DeviceAllocation
+{
+	auto const memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+	auto const blockSize       = blockSizes.at(memoryTypeIndex);
+
+	// large resources would fragment the blocks, so they get their own memory
+	if (prefersDedicated or requirements.size > blockSize / 2u) {
+		return allocateDedicated(requirements, memoryTypeIndex, dedicatedInfo);
+	}
+
+	auto const lock      = std::scoped_lock{mutex};
+	auto const poolIndex = memoryTypeIndex * RESOURCE_KIND_COUNT + static_cast<std::uint32_t>(kind);
+	auto&      pool      = pools.at(poolIndex);
+
+	auto const subAllocate = [&](DeviceMemoryBlock& block) -> std::optional<DeviceAllocation>
+	{
+		auto const range = block.buddy.allocate(requirements.size, requirements.alignment);
+		if (not range.has_value()) {
+			return {};
+		}
+
+		auto allocation           = DeviceAllocation{};
+		allocation.allocator      = this;
+		allocation.block          = &block;
+		allocation.range          = *range;
+		allocation.deviceMemory   = *block.memory;
+		allocation.memoryOffset   = range->offset;
+		allocation.allocationSize = requirements.size;
+		allocation.mapped         = block.mapped == nullptr ? nullptr : static_cast<std::byte*>(block.mapped) + range->offset;
+		++allocationCount;
+
+		return allocation;
+	};
+
+	for (auto const& block : pool.blocks) {
+		if (auto allocation = subAllocate(*block); allocation.has_value()) {
+			return std::move(*allocation);
+		}
+	}
+
+	auto memory = device.allocateMemory(vk::MemoryAllocateInfo{blockSize, memoryTypeIndex});
+	auto mapped = isHostVisible(memoryProperties, memoryTypeIndex) ? memory.mapMemory(0u, VK_WHOLE_SIZE) : nullptr;
+	pool.blocks.push_back(
+	    std::make_unique<DeviceMemoryBlock>(DeviceMemoryBlock{std::move(memory), BuddyAllocator{blockSize, MIN_BLOCK_SIZE}, mapped, poolIndex}));
+
+	return std::move(*subAllocate(*pool.blocks.back()));
+}
+
+auto DeviceAllocator::allocateDedicated(vk::MemoryRequirements const&          requirements,
+                                        std::uint32_t const                    memoryTypeIndex,
+                                        vk::MemoryDedicatedAllocateInfo const& dedicatedInfo) -> DeviceAllocation
+{
+	auto allocation            = DeviceAllocation{};
+	allocation.dedicatedMemory = device.allocateMemory(vk::MemoryAllocateInfo{requirements.size, memoryTypeIndex, &dedicatedInfo});
+	allocation.allocator       = this;
+	allocation.deviceMemory    = *allocation.dedicatedMemory;
+	allocation.allocationSize  = requirements.size;
+	allocation.mapped = isHostVisible(memoryProperties, memoryTypeIndex) ? allocation.dedicatedMemory.mapMemory(0u, VK_WHOLE_SIZE) : nullptr;
+
+	auto const lock = std::scoped_lock{mutex};
+	++dedicatedAllocationCount;
+	++allocationCount;
+	dedicatedBytes += requirements.size;
+
+	return allocation;
+}
+
+auto DeviceAllocator::free(DeviceAllocation& allocation) -> void
+{
+	auto const lock = std::scoped_lock{mutex};
+	--allocationCount;
+
+	if (allocation.block == nullptr) {
+		--dedicatedAllocationCount;
+		dedicatedBytes -= allocation.allocationSize;
+		return;
+	}
+
+	auto& block = *allocation.block;
+	block.buddy.free(allocation.range);
+
+	// keep one block per pool around so that allocation churn does not hit vkAllocateMemory every time
+	if (auto& blocks = pools.at(block.poolIndex).blocks; block.buddy.empty() and blocks.size() > 1u) {
+		std::erase_if(blocks, [&block](auto const& candidate) { return candidate.get() == &block; });
+	}
+}
+
+auto DeviceAllocator::statistics() const -> DeviceAllocatorStatistics
+{
+	auto const lock  = std::scoped_lock{mutex};
+	auto       stats = DeviceAllocatorStatistics{0u, dedicatedAllocationCount, allocationCount, dedicatedBytes, dedicatedBytes};
+
+	for (auto const& pool : pools) {
+		for (auto const& block : pool.blocks) {
+			++stats.blockCount;
+			stats.reservedBytes += block->buddy.capacity();
+			stats.usedBytes += block->buddy.used();
+		}
+	}
+
+	return stats;
+}
+}// namespace HelloTriangle
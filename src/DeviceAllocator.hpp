@@ -0,0 +1,125 @@
+#pragma once
+
+#include "BuddyAllocator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+class DeviceAllocator;
+
+// Buffers and linear images must not share a page with optimal-tiling images (bufferImageGranularity), so they get separate pools.
+enum class ResourceKind : std::uint32_t
+{
+	Linear,
+	Optimal,
+	Count
+};
+
+struct DeviceMemoryBlock
+{
+	vkr::DeviceMemory memory;
+	BuddyAllocator    buddy;
+	void*             mapped{};
+	std::uint32_t     poolIndex{};
+};
+
+class DeviceAllocation
+{
+public:
+	DeviceAllocation() = default;
+	DeviceAllocation(DeviceAllocation const&) = delete;
+	DeviceAllocation(DeviceAllocation&&) noexcept;
+	auto operator=(DeviceAllocation const&) -> DeviceAllocation& = delete;
+	auto operator=(DeviceAllocation&&) noexcept -> DeviceAllocation&;
+	~DeviceAllocation();
+
+	[[nodiscard]] auto memory() const -> vk::DeviceMemory { return deviceMemory; }
+	[[nodiscard]] auto offset() const -> vk::DeviceSize { return memoryOffset; }
+	[[nodiscard]] auto size() const -> vk::DeviceSize { return allocationSize; }
+	// persistently mapped pointer to the start of this allocation; null unless the memory is host visible
+	[[nodiscard]] auto mappedData() const -> void* { return mapped; }
+
+private:
+	friend class DeviceAllocator;
+
+	DeviceAllocator*           allocator{};
+	DeviceMemoryBlock*         block{};
+	BuddyAllocator::Allocation range{};
+	vkr::DeviceMemory          dedicatedMemory{nullptr};
+	vk::DeviceMemory           deviceMemory{};
+	vk::DeviceSize             memoryOffset{};
+	vk::DeviceSize             allocationSize{};
+	void*                      mapped{};
+
+	auto release() -> void;
+};
+
+struct BufferAndMemory
+{
+	vkr::Buffer      buffer;
+	DeviceAllocation allocation;
+};
+
+struct ImageAndMemory
+{
+	vkr::Image       image;
+	DeviceAllocation allocation;
+};
+
+struct DeviceAllocatorStatistics
+{
+	std::uint32_t  blockCount{};
+	std::uint32_t  dedicatedAllocationCount{};
+	std::uint64_t  allocationCount{};
+	vk::DeviceSize reservedBytes{};
+	vk::DeviceSize usedBytes{};
+};
+
+class DeviceAllocator
+{
+public:
+	DeviceAllocator(vkr::Device const&, vkr::PhysicalDevice const&);
+	DeviceAllocator(DeviceAllocator const&)                    = delete;
+	auto operator=(DeviceAllocator const&) -> DeviceAllocator& = delete;
+	~DeviceAllocator();
+
+	// allocate and bind memory for a resource, honouring the driver's dedicated-allocation preference
+	[[nodiscard]] auto allocateFor(vkr::Buffer const&, vk::MemoryPropertyFlags const&) -> DeviceAllocation;
+	[[nodiscard]] auto allocateFor(vkr::Image const&, vk::ImageTiling const&, vk::MemoryPropertyFlags const&) -> DeviceAllocation;
+
+	[[nodiscard]] auto findMemoryType(std::uint32_t, vk::MemoryPropertyFlags const&) const -> std::uint32_t;
+	[[nodiscard]] auto hasMemoryType(std::uint32_t, vk::MemoryPropertyFlags const&) const -> bool;
+	[[nodiscard]] auto statistics() const -> DeviceAllocatorStatistics;
+
+	static constexpr auto MIN_BLOCK_SIZE = vk::DeviceSize{256};
+
+private:
+	friend class DeviceAllocation;
+
+	struct Pool
+	{
+		std::vector<std::unique_ptr<DeviceMemoryBlock>> blocks{};
+	};
+
+	vkr::Device const&                       device;
+	vk::PhysicalDeviceMemoryProperties const memoryProperties;
+	std::vector<vk::DeviceSize>              blockSizes;
+	std::vector<Pool>                        pools;
+	mutable std::mutex                       mutex{};
+	std::uint32_t                            dedicatedAllocationCount{};
+	std::uint64_t                            allocationCount{};
+	vk::DeviceSize                           dedicatedBytes{};
+
+	auto allocate(vk::MemoryRequirements const&, vk::MemoryPropertyFlags const&, ResourceKind, bool, vk::MemoryDedicatedAllocateInfo const&)
+	    -> DeviceAllocation;
+	auto allocateDedicated(vk::MemoryRequirements const&, std::uint32_t, vk::MemoryDedicatedAllocateInfo const&) -> DeviceAllocation;
+	auto free(DeviceAllocation&) -> void;
+};
+}// namespace HelloTriangle
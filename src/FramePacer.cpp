@@ -0,0 +1,55 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto makeFences(vkr::Device const& device, std::uint32_t const count) -> std::vector<vkr::Fence>
+{
+	if (count == 0u) {
+		throw std::invalid_argument{"a frame pacer needs at least one frame in flight"};
+	}
+
+	// signalled, so that the first wait on each slot returns at once
+	constexpr auto fenceInfo = vk::FenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
+
+	auto fences = std::vector<vkr::Fence>{};
+	fences.reserve(count);
+	std::ranges::generate_n(std::back_inserter(fences), count, [&] { return device.createFence(fenceInfo); });
+
+	return fences;
+}
+}// namespace
+
+FramePacer::FramePacer(vkr::Device const& logicalDevice, std::uint32_t const framesInFlight, bool const lowLatency)
+    : device{logicalDevice},
+      fences{makeFences(logicalDevice, framesInFlight)},
+      waitsBeforeInput{lowLatency}
+{}
+
+auto FramePacer::waitBeforeInput() const -> void
+{
+	// a fence signal orders after every earlier submission to the queue, so the latest one covers them all
+	if (waitsBeforeInput) {
+		wait(previousFrame());
+	}
+}
+
+auto FramePacer::waitForFrame() const -> void { wait(current); }
+
+auto FramePacer::resetFence() const -> void { device.resetFences(*fences.at(current)); }
+
+auto FramePacer::advance() -> void { current = (current + 1u) % framesInFlight(); }
+
+auto FramePacer::wait(std::uint32_t const frame) const -> void
+{
+	if (device.waitForFences(*fences.at(frame), VK_TRUE, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) {
+		throw std::runtime_error{"failed to wait for a frame's fence"};
+	}
+}
+}// namespace HelloTriangle
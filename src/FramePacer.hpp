@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// Decides how far the CPU runs ahead of the GPU. Each of framesInFlight slots has a fence its submission signals, and a slot's
+// resources are reused only once that fence has, so more slots buy throughput with latency. In low-latency mode the CPU also waits
+// for the latest submission to finish before it samples input, which makes it one frame in flight whatever framesInFlight says:
+// the GPU sits idle while the next frame is polled, recorded and submitted, trading that throughput for the freshest input.
+class FramePacer
+{
+public:
+	FramePacer(vkr::Device const&, std::uint32_t framesInFlight, bool lowLatency);
+
+	[[nodiscard]] auto framesInFlight() const -> std::uint32_t { return static_cast<std::uint32_t>(fences.size()); }
+	[[nodiscard]] auto lowLatency() const -> bool { return waitsBeforeInput; }
+	// the slot being prepared, and the one submitted before it
+	[[nodiscard]] auto frame() const -> std::uint32_t { return current; }
+	[[nodiscard]] auto previousFrame() const -> std::uint32_t { return (current + framesInFlight() - 1u) % framesInFlight(); }
+	// signalled by the slot's submission; unsignalled only by resetFence
+	[[nodiscard]] auto fence() const -> vk::Fence { return *fences.at(current); }
+
+	// does nothing unless in low-latency mode; call just before sampling input
+	auto waitBeforeInput() const -> void;
+	// blocks until the slot's last submission has finished with its resources
+	auto waitForFrame() const -> void;
+	// once the frame is certain to submit, so that a frame abandoned before then leaves the fence signalled
+	auto resetFence() const -> void;
+	auto advance() -> void;
+
+private:
+	vkr::Device const&      device;
+	std::vector<vkr::Fence> fences;
+	bool                    waitsBeforeInput;
+	std::uint32_t           current{};
+
+	auto wait(std::uint32_t frame) const -> void;
+};
+}// namespace HelloTriangle
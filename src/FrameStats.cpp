@@ -0,0 +1,214 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace rv = std::ranges::views;
+
+namespace
+{
+auto elapsedMilliseconds(FrameStats::Clock::time_point const from, FrameStats::Clock::time_point const to) -> double
+{
+	return std::chrono::duration<double, std::milli>{to - from}.count();
+}
+
+auto formatSummary(TimingSummary const& summary) -> std::string
+{
+	return fmt::format(R"({{"mean": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, "max": {:.4f}}})",
+	                   summary.mean,
+	                   summary.p50,
+	                   summary.p95,
+	                   summary.p99,
+	                   summary.max);
+}
+
+// device names come from the driver, so quotes, backslashes and control characters are escaped to keep the report valid JSON
+auto escapeJson(std::string_view const text) -> std::string
+{
+	auto escaped = std::string{};
+	escaped.reserve(text.size());
+	for (auto const character : text) {
+		switch (character) {
+		case '"': escaped += "\\\""; break;
+		case '\\': escaped += "\\\\"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\t': escaped += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(character) < 0x20u) {
+				escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(static_cast<unsigned char>(character)));
+			} else {
+				escaped += character;
+			}
+		}
+	}
+
+	return escaped;
+}
+
+template<typename Sample>
+auto recordSample(std::vector<Sample>& samples, Sample const& sample, std::size_t const capacity, std::size_t& recorded) -> void
+{
+	if (capacity == 0u) {
+		return;
+	}
+	if (samples.size() < capacity) {
+		samples.push_back(sample);
+	} else {
+		samples.at(recorded % capacity) = sample;
+	}
+	++recorded;
+}
+}// namespace
+
+auto FrameStats::setCapacity(std::size_t const frameCount) -> void
+{
+	capacity          = frameCount;
+	framesRecorded    = 0u;
+	gpuFramesRecorded = 0u;
+	frameTimings.clear();
+	frameTimings.reserve(capacity);
+	gpuFrames.clear();
+	gpuFrames.reserve(capacity);
+	latenciesRecorded = 0u;
+	inputLatencies.clear();
+	inputLatencies.reserve(capacity);
+}
+
+auto FrameStats::beginFrame() -> void
+{
+	currentFrame = {};
+	frameStart   = Clock::now();
+	phaseStart   = frameStart;
+}
+
+auto FrameStats::endPhase(FramePhase const phase) -> void
+{
+	auto const now = Clock::now();
+	currentFrame.phaseMilliseconds.at(static_cast<std::size_t>(phase)) += elapsedMilliseconds(phaseStart, now);
+	phaseStart = now;
+}
+
+auto FrameStats::skipElapsed() -> void
+{
+	auto const now = Clock::now();
+	frameStart += now - phaseStart;
+	phaseStart = now;
+}
+
+auto FrameStats::endFrame() -> void
+{
+	currentFrame.totalMilliseconds = elapsedMilliseconds(frameStart, Clock::now());
+	recordSample(frameTimings, currentFrame, capacity, framesRecorded);
+}
+
+auto FrameStats::recordGpuFrame(GpuFrameStats const& gpuFrame) -> void
+{
+	lastGpuFrame = gpuFrame;
+	recordSample(gpuFrames, gpuFrame, capacity, gpuFramesRecorded);
+}
+
+auto FrameStats::inputSampled() -> void { inputTime = Clock::now(); }
+
+auto FrameStats::submitted() -> void
+{
+	if (inputTime.has_value()) {
+		recordSample(inputLatencies, elapsedMilliseconds(*inputTime, Clock::now()), capacity, latenciesRecorded);
+		inputTime.reset();
+	}
+}
+
+auto FrameStats::summariseFrames() const -> TimingSummary
+{
+	auto samples = std::vector<double>{};
+	samples.reserve(frameTimings.size());
+	std::ranges::transform(frameTimings, std::back_inserter(samples), &FrameTiming::totalMilliseconds);
+
+	return summarise(std::move(samples));
+}
+
+auto FrameStats::summarisePhase(FramePhase const phase) const -> TimingSummary
+{
+	auto samples = std::vector<double>{};
+	samples.reserve(frameTimings.size());
+	std::ranges::transform(frameTimings,
+	                       std::back_inserter(samples),
+	                       [phase](auto const& timing) { return timing.phaseMilliseconds.at(static_cast<std::size_t>(phase)); });
+
+	return summarise(std::move(samples));
+}
+
+auto FrameStats::summariseGpuFrames() const -> TimingSummary
+{
+	auto samples = std::vector<double>{};
+	samples.reserve(gpuFrames.size());
+	std::ranges::transform(gpuFrames, std::back_inserter(samples), &GpuFrameStats::gpuMilliseconds);
+
+	return summarise(std::move(samples));
+}
+
+auto FrameStats::summariseInputLatency() const -> TimingSummary { return summarise(inputLatencies); }
+
+auto FrameStats::summarise(std::vector<double> samples) -> TimingSummary
+{
+	if (samples.empty()) {
+		return {};
+	}
+
+	std::ranges::sort(samples);
+
+	// nearest-rank percentile
+	auto const percentile = [&samples](double const p)
+	{
+		auto const rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(samples.size())));
+		return samples.at(std::clamp<std::size_t>(rank, 1u, samples.size()) - 1u);
+	};
+	auto const mean = std::accumulate(std::begin(samples), std::end(samples), 0.0) / static_cast<double>(samples.size());
+
+	return {mean, percentile(50.0), percentile(95.0), percentile(99.0), samples.back()};
+}
+
+auto FrameStats::writeJson(std::filesystem::path const& filePath, std::string_view const deviceName) const -> void
+{
+	auto out = fmt::memory_buffer{};
+
+	fmt::format_to(std::back_inserter(out), "{{\n");
+	fmt::format_to(std::back_inserter(out), "\t\"device\": \"{}\",\n", escapeJson(deviceName));
+	fmt::format_to(std::back_inserter(out), "\t\"frames\": {},\n", frameTimings.size());
+	fmt::format_to(std::back_inserter(out), "\t\"frameTimeMs\": {},\n", formatSummary(summariseFrames()));
+	fmt::format_to(std::back_inserter(out), "\t\"phasesMs\": {{\n");
+	for (auto const i : rv::iota(std::size_t{0}, FRAME_PHASE_COUNT)) {
+		fmt::format_to(std::back_inserter(out),
+		               "\t\t\"{}\": {}{}\n",
+		               FRAME_PHASE_NAMES.at(i),
+		               formatSummary(summarisePhase(static_cast<FramePhase>(i))),
+		               i + 1 == FRAME_PHASE_COUNT ? "" : ",");
+	}
+	fmt::format_to(std::back_inserter(out), "\t}},\n");
+	fmt::format_to(std::back_inserter(out), "\t\"inputToSubmitMs\": {},\n", formatSummary(summariseInputLatency()));
+	fmt::format_to(std::back_inserter(out), "\t\"gpuFrames\": {},\n", gpuFrames.size());
+	fmt::format_to(std::back_inserter(out), "\t\"gpuFrameTimeMs\": {},\n", formatSummary(summariseGpuFrames()));
+	fmt::format_to(std::back_inserter(out),
+	               "\t\"pipelineStatistics\": {{\"vertexShaderInvocations\": {}, \"clippingInvocations\": {}, \"clippingPrimitives\": {}, "
+	               "\"fragmentShaderInvocations\": {}}}\n}}\n",
+	               lastGpuFrame.vertexShaderInvocations,
+	               lastGpuFrame.clippingInvocations,
+	               lastGpuFrame.clippingPrimitives,
+	               lastGpuFrame.fragmentShaderInvocations);
+
+	auto file = std::ofstream{filePath, std::ios::out | std::ios::trunc};
+	if (!file.is_open()) {
+		throw std::runtime_error{fmt::format("failed to open file: {}", filePath.string())};
+	}
+	file.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+}// namespace HelloTriangle
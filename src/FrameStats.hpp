@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace HelloTriangle
+{
+enum class FramePhase : std::size_t
+{
+	FenceWait,
+	Input,
+	Acquire,
+	Record,
+	Submit,
+	Present,
+	Count
+};
+
+inline constexpr auto FRAME_PHASE_COUNT = static_cast<std::size_t>(FramePhase::Count);
+inline constexpr auto FRAME_PHASE_NAMES = std::array{"fenceWait", "input", "acquire", "record", "submit", "present"};
+
+struct FrameTiming
+{
+	std::array<double, FRAME_PHASE_COUNT> phaseMilliseconds{};
+	double                                totalMilliseconds{};
+};
+
+struct GpuFrameStats
+{
+	double        gpuMilliseconds{};
+	std::uint64_t vertexShaderInvocations{};
+	std::uint64_t clippingInvocations{};
+	std::uint64_t clippingPrimitives{};
+	std::uint64_t fragmentShaderInvocations{};
+};
+
+struct TimingSummary
+{
+	double mean{};
+	double p50{};
+	double p95{};
+	double p99{};
+	double max{};
+};
+
+class FrameStats
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr auto DEFAULT_CAPACITY = std::size_t{256};
+
+	// keeps the most recent frames only; benchmarks size this to their frame count
+	auto setCapacity(std::size_t) -> void;
+	auto beginFrame() -> void;
+	auto endPhase(FramePhase) -> void;
+	auto skipElapsed() -> void;
+	auto endFrame() -> void;
+	auto recordGpuFrame(GpuFrameStats const&) -> void;
+	// input-to-submit latency, for frames built from freshly sampled input; a submission with no input sampled since is not counted
+	auto inputSampled() -> void;
+	auto submitted() -> void;
+
+	[[nodiscard]] auto frameCount() const -> std::size_t { return frameTimings.size(); }
+	[[nodiscard]] auto summariseFrames() const -> TimingSummary;
+	[[nodiscard]] auto summarisePhase(FramePhase) const -> TimingSummary;
+	[[nodiscard]] auto summariseGpuFrames() const -> TimingSummary;
+	[[nodiscard]] auto summariseInputLatency() const -> TimingSummary;
+	[[nodiscard]] auto latestGpuFrame() const -> GpuFrameStats const& { return lastGpuFrame; }
+	auto               writeJson(std::filesystem::path const&, std::string_view deviceName) const -> void;
+
+private:
+	std::size_t                      capacity{DEFAULT_CAPACITY};
+	std::size_t                      framesRecorded{};
+	std::vector<FrameTiming>         frameTimings{};
+	FrameTiming                      currentFrame{};
+	Clock::time_point                frameStart{};
+	Clock::time_point                phaseStart{};
+	std::size_t                      gpuFramesRecorded{};
+	std::vector<GpuFrameStats>       gpuFrames{};
+	GpuFrameStats                    lastGpuFrame{};
+	std::optional<Clock::time_point> inputTime{};
+	std::size_t                      latenciesRecorded{};
+	std::vector<double>              inputLatencies{};
+
+	static auto summarise(std::vector<double>) -> TimingSummary;
+};
+}// namespace HelloTriangle
@@ -0,0 +1,168 @@
+#include "FrustumCuller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <glm/geometric.hpp>
+#include <glm/vec4.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+// matches local_size_x in cull.comp
+constexpr auto CULL_WORKGROUP_SIZE = 64u;
+
+// the push constants cull.comp declares; 120 bytes, inside the 128 every device offers
+struct CullParameters
+{
+	std::array<glm::vec4, 6> frustumPlanes{};
+	glm::vec4                boundingSphere{};
+	std::uint32_t            instanceCount{};
+	std::uint32_t            submeshCount{};
+};
+static_assert(sizeof(CullParameters) == 120u);
+
+// bindings 0 and 1 are shared by every frame, 2 and 3 are the frame's own outputs
+auto makeCullDescriptorSetLayout(vkr::Device const& device) -> vkr::DescriptorSetLayout
+{
+	auto const bindings = std::array{
+	    vk::DescriptorSetLayoutBinding{0u, vk::DescriptorType::eStorageBuffer, 1u, vk::ShaderStageFlagBits::eCompute},
+	    vk::DescriptorSetLayoutBinding{1u, vk::DescriptorType::eStorageBuffer, 1u, vk::ShaderStageFlagBits::eCompute},
+	    vk::DescriptorSetLayoutBinding{2u, vk::DescriptorType::eStorageBuffer, 1u, vk::ShaderStageFlagBits::eCompute},
+	    vk::DescriptorSetLayoutBinding{3u, vk::DescriptorType::eStorageBuffer, 1u, vk::ShaderStageFlagBits::eCompute},
+	};
+
+	return device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{{}, bindings});
+}
+
+auto makeCullPipelineLayout(vkr::Device const& device, vkr::DescriptorSetLayout const& setLayout) -> vkr::PipelineLayout
+{
+	constexpr auto pushConstantRange = vk::PushConstantRange{vk::ShaderStageFlagBits::eCompute, 0u, sizeof(CullParameters)};
+
+	return device.createPipelineLayout(vk::PipelineLayoutCreateInfo{{}, *setLayout, pushConstantRange});
+}
+
+auto makeCullPipeline(vkr::Device const&         device,
+                      vkr::PipelineCache const&  pipelineCache,
+                      vkr::ShaderModule const&   shader,
+                      vkr::PipelineLayout const& layout) -> vkr::Pipeline
+{
+	auto const stageInfo = vk::PipelineShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eCompute, *shader, "main"};
+
+	return device.createComputePipeline(pipelineCache, vk::ComputePipelineCreateInfo{{}, stageInfo, *layout});
+}
+
+auto makeBuffer(vkr::Device const&             device,
+                DeviceAllocator&               allocator,
+                vk::DeviceSize const           size,
+                vk::BufferUsageFlags const&    usage,
+                vk::MemoryPropertyFlags const& properties) -> BufferAndMemory
+{
+	auto buffer     = device.createBuffer(vk::BufferCreateInfo{{}, size, usage});
+	auto allocation = allocator.allocateFor(buffer, properties);
+
+	return {std::move(buffer), std::move(allocation)};
+}
+
+// Gribb and Hartmann: each plane is a sum or difference of rows of the clip-space transform, with depth running 0 to 1. The planes
+// are normalised so that a signed distance compares directly against a radius; positive is inside.
+auto frustumPlanes(glm::mat4 const& viewProjection) -> std::array<glm::vec4, 6>
+{
+	auto const row = [&](int const index)
+	{ return glm::vec4{viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]}; };
+
+	auto planes = std::array{row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+	for (auto& plane : planes) {
+		plane /= glm::length(glm::vec3{plane});
+	}
+
+	return planes;
+}
+}// namespace
+
+FrustumCuller::FrustumCuller(vkr::Device const&        device,
+                             DeviceAllocator&          allocator,
+                             vkr::PipelineCache const& pipelineCache,
+                             vkr::ShaderModule const&  shader,
+                             std::uint32_t const       framesInFlight,
+                             Scene const&              scene)
+    : instanceCount{scene.instanceCount},
+      submeshCount{static_cast<std::uint32_t>(scene.submeshes.size())},
+      maxDrawCount{instanceCount * submeshCount},
+      bounds{scene.bounds},
+      descriptorSetLayout{makeCullDescriptorSetLayout(device)},
+      layout{makeCullPipelineLayout(device, descriptorSetLayout)},
+      pipeline{makeCullPipeline(device, pipelineCache, shader, layout)},
+      submeshTable{makeBuffer(device,
+                              allocator,
+                              scene.submeshes.size_bytes(),
+                              vk::BufferUsageFlagBits::eStorageBuffer,
+                              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent)},
+      descriptorPool{device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+          vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+          framesInFlight,
+          vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 4u * framesInFlight}})}
+{
+	if (maxDrawCount == 0u) {
+		throw std::invalid_argument{"nothing to cull: the scene has no instances or no submeshes"};
+	}
+
+	std::ranges::copy(scene.submeshes, static_cast<Submesh*>(submeshTable.allocation.mappedData()));
+
+	auto const layouts = std::vector(framesInFlight, *descriptorSetLayout);
+	auto       sets    = vkr::DescriptorSets{device, vk::DescriptorSetAllocateInfo{*descriptorPool, layouts}};
+
+	frames.reserve(framesInFlight);
+	for (auto& set : sets) {
+		auto draws = makeBuffer(device,
+		                        allocator,
+		                        vk::DeviceSize{sizeof(vk::DrawIndexedIndirectCommand)} * maxDrawCount,
+		                        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+		                        vk::MemoryPropertyFlagBits::eDeviceLocal);
+		auto drawCount = makeBuffer(device,
+		                            allocator,
+		                            sizeof(std::uint32_t),
+		                            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+		                                vk::BufferUsageFlagBits::eTransferDst,
+		                            vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+		auto const bufferInfos = std::array{vk::DescriptorBufferInfo{scene.instances, 0u, VK_WHOLE_SIZE},
+		                                    vk::DescriptorBufferInfo{*submeshTable.buffer, 0u, VK_WHOLE_SIZE},
+		                                    vk::DescriptorBufferInfo{*draws.buffer, 0u, VK_WHOLE_SIZE},
+		                                    vk::DescriptorBufferInfo{*drawCount.buffer, 0u, VK_WHOLE_SIZE}};
+		device.updateDescriptorSets(vk::WriteDescriptorSet{*set, 0u, 0u, vk::DescriptorType::eStorageBuffer, {}, bufferInfos}, {});
+
+		frames.push_back({std::move(draws), std::move(drawCount), std::move(set)});
+	}
+}
+
+auto FrustumCuller::recordCulling(vkr::CommandBuffer const& commandBuffer, std::uint32_t const frame, glm::mat4 const& viewProjection) const
+    -> void
+{
+	auto const& [draws, drawCount, descriptorSet] = frames.at(frame);
+
+	// the frame's previous draws were issued before its fence signalled, so only the clear has to be ordered before the shader
+	commandBuffer.fillBuffer(*drawCount.buffer, 0u, sizeof(std::uint32_t), 0u);
+	constexpr auto clearBarrier =
+	    vk::MemoryBarrier{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, clearBarrier, {}, {});
+
+	auto const parameters = CullParameters{frustumPlanes(viewProjection), glm::vec4{bounds.centre, bounds.radius}, instanceCount, submeshCount};
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+	commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *layout, 0u, *descriptorSet, {});
+	commandBuffer.pushConstants<CullParameters>(*layout, vk::ShaderStageFlagBits::eCompute, 0u, parameters);
+	commandBuffer.dispatch((instanceCount + CULL_WORKGROUP_SIZE - 1u) / CULL_WORKGROUP_SIZE, 1u, 1u);
+
+	constexpr auto drawBarrier = vk::MemoryBarrier{vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect, {}, drawBarrier, {}, {});
+}
+
+auto FrustumCuller::recordDraws(vkr::CommandBuffer const& commandBuffer, std::uint32_t const frame) const -> void
+{
+	auto const& [draws, drawCount, descriptorSet] = frames.at(frame);
+	commandBuffer.drawIndexedIndirectCount(
+	    *draws.buffer, 0u, *drawCount.buffer, 0u, maxDrawCount, static_cast<std::uint32_t>(sizeof(vk::DrawIndexedIndirectCommand)));
+}
+}// namespace HelloTriangle
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "DeviceAllocator.hpp"
+#include "Mesh.hpp"
+
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// Frustum culling on the GPU. Each frame a compute pass tests every instance's bounding sphere against the view frustum and appends
+// one indirect draw per submesh of each visible instance, drawing that instance alone through firstInstance, along with a count of
+// the draws written; the render pass then issues them all with one drawIndexedIndirectCount. Nothing the CPU records depends on the
+// instance count. The device needs the drawIndirectCount and drawIndirectFirstInstance features.
+class FrustumCuller
+{
+public:
+	struct Scene
+	{
+		vk::Buffer               instances;// one mat4 model matrix per instance, as the vertex shader reads them
+		std::uint32_t            instanceCount{};
+		std::span<Submesh const> submeshes;
+		BoundingSphere           bounds;// in the space the model matrices transform from
+	};
+
+	FrustumCuller(vkr::Device const&,
+	              DeviceAllocator&,
+	              vkr::PipelineCache const&,
+	              vkr::ShaderModule const&,
+	              std::uint32_t framesInFlight,
+	              Scene const&);
+
+	// outside a render pass: clear the frame's draw count, cull, and make the draws visible to the indirect command stage
+	auto recordCulling(vkr::CommandBuffer const&, std::uint32_t frame, glm::mat4 const& viewProjection) const -> void;
+	// inside the render pass, with the graphics pipeline, vertex and index buffers and descriptor sets already bound
+	auto recordDraws(vkr::CommandBuffer const&, std::uint32_t frame) const -> void;
+
+private:
+	// written by the frame's culling pass and read by its draws; one per frame in flight, so a frame never overwrites draws that an
+	// earlier frame still has to issue
+	struct FrameDraws
+	{
+		BufferAndMemory    draws;
+		BufferAndMemory    drawCount;
+		vkr::DescriptorSet descriptorSet;
+	};
+
+	std::uint32_t            instanceCount;
+	std::uint32_t            submeshCount;
+	std::uint32_t            maxDrawCount;
+	BoundingSphere           bounds;
+	vkr::DescriptorSetLayout descriptorSetLayout;
+	vkr::PipelineLayout      layout;
+	vkr::Pipeline            pipeline;
+	BufferAndMemory          submeshTable;
+	vkr::DescriptorPool      descriptorPool;
+	std::vector<FrameDraws>  frames{};
+};
+}// namespace HelloTriangle
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace HelloTriangle
+{
+// MurmurHash64A over raw bytes: fast, well mixed, and stable across runs, so it can key on-disk data.
+inline auto hashBytes(std::span<std::byte const> const bytes, std::uint64_t const seed = 0u) -> std::uint64_t
+{
+	constexpr auto multiplier = std::uint64_t{0xc6a4a7935bd1e995u};
+	constexpr auto shift      = 47;
+
+	auto       hash      = seed ^ (bytes.size() * multiplier);
+	auto const wordCount = bytes.size() / sizeof(std::uint64_t);
+
+	for (auto i = std::size_t{0}; i < wordCount; ++i) {
+		auto word = std::uint64_t{};
+		std::memcpy(&word, bytes.data() + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+
+		word *= multiplier;
+		word ^= word >> shift;
+		word *= multiplier;
+
+		hash ^= word;
+		hash *= multiplier;
+	}
+
+	auto const tail = bytes.subspan(wordCount * sizeof(std::uint64_t));
+	for (auto i = std::size_t{0}; i < tail.size(); ++i) {
+		hash ^= static_cast<std::uint64_t>(tail[i]) << (8u * i);
+	}
+	if (not tail.empty()) {
+		hash *= multiplier;
+	}
+
+	hash ^= hash >> shift;
+	hash *= multiplier;
+	hash ^= hash >> shift;
+
+	return hash;
+}
+}// namespace HelloTriangle
@@ -1,23 +1,35 @@
 #define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
-#define GLM_ENABLE_EXPERIMENTAL
-#define TINYOBJLOADER_IMPLEMENTATION
 
 #include "HelloTriangleApplication.hpp"
 
+#include "Ktx2.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimiser.hpp"
+#include "MipChain.hpp"
+#include "ObjLoader.hpp"
+#include "TexelExpansion.hpp"
+#include "cull.comp.spv.hpp"
+#include "triangle.frag.spv.hpp"
+#include "triangle.vert.spv.hpp"
+
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <fmt/format.h>
 #include <fstream>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/hash.hpp>
+#include <numbers>
 #include <numeric>
 #include <set>
 #include <stb_image.h>
-#include <tiny_obj_loader.h>
-#include <unordered_map>
+#include <stb_image_write.h>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vulkan/vulkan_raii.hpp>
 
@@ -39,9 +51,9 @@ auto getGLFWInstanceExtensions() -> std::vector<char const*>
 	return extensions;
 }
 
-auto getRequiredExtensions(bool const enableValidationLayers) -> std::vector<char const*>
+auto getRequiredExtensions(bool const enableValidationLayers, bool const headless) -> std::vector<char const*>
 {
-	auto extensions = getGLFWInstanceExtensions();
+	auto extensions = headless ? std::vector<char const*>{} : getGLFWInstanceExtensions();
 
 	if (enableValidationLayers) {
 		extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -50,6 +62,15 @@ auto getRequiredExtensions(bool const enableValidationLayers) -> std::vector<cha
 	return extensions;
 }
 
+auto getRequiredDeviceExtensions(bool const headless) -> std::span<char const*>
+{
+	if (headless) {
+		return {};
+	}
+
+	return requiredDeviceExtensions;
+}
+
 auto checkValidationLayerSupport(vkr::Context const& context, std::span<char const*> requiredValLayers) -> bool
 {
 	static auto availableValLayers    = context.enumerateInstanceLayerProperties();
@@ -166,20 +187,40 @@ auto isDeviceSuitable(vkr::PhysicalDevice const& physDev, vkr::SurfaceKHR const&
 		return false;
 	}
 
-	return indices.isComplete() and Application::SwapchainSupportDetails(physDev, surface).isAdequate() and supportedFeatures.samplerAnisotropy;
+	// uploads are tracked with timeline semaphores
+	auto const timelineSemaphores =
+	    physDev.getProperties().apiVersion >= VK_API_VERSION_1_2 and
+	    physDev.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>().get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore;
+
+	return indices.isComplete() and (not *surface or Application::SwapchainSupportDetails(physDev, surface).isAdequate()) and
+	       supportedFeatures.samplerAnisotropy and timelineSemaphores;
 }
 
-auto chooseSwapPresentMode(std::span<vk::PresentModeKHR const> availablePresentModes) -> vk::PresentModeKHR
+// FIFO is the one mode every surface supports, so only an explicit request for another can fail
+auto chooseSwapPresentMode(std::span<vk::PresentModeKHR const> availablePresentModes, PresentMode const requested) -> vk::PresentModeKHR
 {
-	static auto const presentMode =
-	    std::ranges::find_if(availablePresentModes,
-	                         [](auto const& availablePresentMode) { return availablePresentMode == vk::PresentModeKHR::eMailbox; });
+	auto const available = [&](vk::PresentModeKHR const mode)
+	{ return std::ranges::find(availablePresentModes, mode) != std::end(availablePresentModes); };
+	auto const required  = [&](vk::PresentModeKHR const mode)
+	{
+		if (not available(mode)) {
+			throw std::runtime_error{fmt::format("the surface does not support the {} present mode", vk::to_string(mode))};
+		}
+		return mode;
+	};
 
-	if (presentMode == std::end(availablePresentModes)) {
+	switch (requested) {
+	case PresentMode::fifo:
 		return vk::PresentModeKHR::eFifo;
+	case PresentMode::mailbox:
+		return required(vk::PresentModeKHR::eMailbox);
+	case PresentMode::immediate:
+		return required(vk::PresentModeKHR::eImmediate);
+	case PresentMode::automatic:
+		break;
 	}
 
-	return *presentMode;
+	return available(vk::PresentModeKHR::eMailbox) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo;
 }
 
 auto frameBufferResizeCallback = [](GLFWwindow* window, [[maybe_unused]] int width, [[maybe_unused]] int height)
@@ -188,15 +229,76 @@ auto frameBufferResizeCallback = [](GLFWwindow* window, [[maybe_unused]] int wid
 	app->framebufferResized = true;
 };
 
-auto hasStencilComponent(vk::Format const& format) -> bool { return format == vk::Format::eD32SfloatS8Uint or format == vk::Format::eD24UnormS8Uint; }
+// the window system has discarded what was shown, e.g. after the window was uncovered
+auto windowRefreshCallback = [](GLFWwindow* window)
+{
+	auto const app       = static_cast<Application*>(glfwGetWindowUserPointer(window));
+	app->redrawRequested = true;
+};
 
-auto vertexHash = [](Vertex const& vertex)
+auto keyCallback = [](GLFWwindow* window, int const key, [[maybe_unused]] int scancode, int const action, [[maybe_unused]] int mods)
 {
-	auto const positionHash = std::hash<glm::vec3>{}(vertex.position);
-	auto const colourHash   = std::hash<glm::vec3>{}(vertex.colour);
-	auto const uvHash       = std::hash<glm::vec2>{}(vertex.texCoord);
-	return ((positionHash ^ (colourHash << 1)) >> 1) ^ (uvHash << 1);
+	if (key == GLFW_KEY_SPACE and action == GLFW_PRESS) {
+		static_cast<Application*>(glfwGetWindowUserPointer(window))->toggleAnimation();
+	}
 };
+
+auto optimiseMesh(VerticesAndIndices<std::uint32_t>& mesh, MeshOptimisation const level) -> void
+{
+	auto const before = analyseVertexCache(mesh.vertexIndices, mesh.vertices.size());
+
+	optimiseVertexCache(mesh.vertexIndices, mesh.vertices.size());
+	if (level == MeshOptimisation::overdraw) {
+		optimiseOverdraw(mesh.vertexIndices, mesh.vertices);
+	}
+	optimiseVertexFetch(mesh);
+
+	auto const after = analyseVertexCache(mesh.vertexIndices, mesh.vertices.size());
+	fmt::print("mesh optimisation: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n", before.acmr, after.acmr, before.atvr, after.atvr);
+}
+
+constexpr auto pipelineStatisticFlags =
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations | vk::QueryPipelineStatisticFlagBits::eClippingInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+// instances stand on a square grid in the z = 0 plane, centred on the origin; the camera backs away as the grid grows
+constexpr auto INSTANCE_SPACING = 2.5f;
+
+auto instanceGridSide(std::uint32_t const instanceCount) -> std::uint32_t
+{
+	auto const side = static_cast<std::uint32_t>(std::sqrt(static_cast<double>(instanceCount)));
+	return side * side < instanceCount ? side + 1u : side;
+}
+
+constexpr auto UNCOMPRESSED_TEXTURE_FORMAT = vk::Format::eR8G8B8A8Srgb;
+constexpr auto COMPRESSED_TEXTURE_FORMATS  = std::array{vk::Format::eBc7SrgbBlock, vk::Format::eBc1RgbSrgbBlock};
+
+// viking_room.png -> viking_room.bc7.ktx2
+auto compressedTexturePath(fs::path const& texturePath, vk::Format const format) -> fs::path
+{
+	return fs::path{texturePath}.replace_extension(format == vk::Format::eBc7SrgbBlock ? ".bc7.ktx2" : ".bc1.ktx2");
+}
+
+// a stale, truncated or corrupt encoding is passed over with a warning, leaving the next one or the source image to be used
+auto isUsableEncoding(fs::path const& path, vk::Format const format) -> bool
+{
+	try {
+		auto const texture = Ktx2Texture{path};
+		if (texture.format() != format) {
+			fmt::print(stderr,
+			           "warning: {} holds {} texels, not the {} its name promises; re-run texture_encoder\n",
+			           path.string(),
+			           vk::to_string(texture.format()),
+			           vk::to_string(format));
+		}
+
+		return texture.format() == format;
+	} catch (std::exception const& e) {
+		fmt::print(stderr, "warning: {}\n", e.what());
+		return false;
+	}
+}
+
 }// namespace
 
 auto makeWindowPointer(Application& app, std::uint32_t const width, std::uint32_t const height, std::string_view const windowName)
@@ -209,28 +311,183 @@ auto makeWindowPointer(Application& app, std::uint32_t const width, std::uint32_
 
 	glfwSetWindowUserPointer(windowPtr.get(), &app);
 	glfwSetFramebufferSizeCallback(windowPtr.get(), frameBufferResizeCallback);
+	glfwSetWindowRefreshCallback(windowPtr.get(), windowRefreshCallback);
+	glfwSetKeyCallback(windowPtr.get(), keyCallback);
 
 	return windowPtr;
 }
 
-Application::Application() = default;
+Application::Application(Options opts) : options{std::move(opts)}
+{
+	assetUploadValue = uploader.submit(std::move(assetUploads));
+}
 
 Application::~Application() = default;
 
 auto Application::run() -> void { mainLoop(); }
 
+auto Application::statistics() const -> FrameStats const& { return frameStats; }
+
+auto Application::memoryStatistics() const -> DeviceAllocatorStatistics { return allocator.statistics(); }
+
 auto Application::mainLoop() -> void
 {
-	while (!glfwWindowShouldClose(window.get())) {
-		glfwPollEvents();
-		try {
-			drawFrame();
-		} catch (vk::OutOfDateKHRError const&) {
-			framebufferResized = false;
-			remakeSwapchain();
+	if (options.benchFrames.has_value()) {
+		frameStats.setCapacity(*options.benchFrames);
+	}
+
+	// frames that are written out or timed should all contain the model, so do not start until it has streamed in
+	if (options.headless or options.benchFrames.has_value()) {
+		uploader.wait(assetUploadValue);
+	}
+
+	if (options.headless) {
+		if (options.readbackDirectory.has_value()) {
+			fs::create_directories(*options.readbackDirectory);
+		}
+
+		auto const loopStartTime = std::chrono::steady_clock::now();
+		for ([[maybe_unused]] auto const frame : rv::iota(0u, options.frameCount)) {
+			drawOffscreenFrame();
 		}
+		logicalDevice.waitIdle();
+		auto const elapsed = std::chrono::duration<double>{std::chrono::steady_clock::now() - loopStartTime};
+		collectInFlightGpuQueries();
+
+		for (auto const i : rv::iota(0u, framesInFlight)) {
+			writeReadback(i);
+		}
+
+		fmt::print("rendered {} frames in {:.3f} s ({:.1f} frames/s)\n",
+		           options.frameCount,
+		           elapsed.count(),
+		           static_cast<double>(options.frameCount) / elapsed.count());
+		writeBenchmarkReport();
+		return;
+	}
+
+	while (!glfwWindowShouldClose(window.get()) and not benchmarkComplete()) {
+		if (options.idle and not redrawNeeded()) {
+			if (not idleSince.has_value()) {
+				idleSince = std::chrono::steady_clock::now();
+			}
+			// woken by input, by the window system, or by the simulation posting an empty event for each step while the scene moves
+			glfwWaitEvents();
+			continue;
+		}
+		endIdlePeriod();
+		redrawRequested = false;
+		sceneMoved.store(false, std::memory_order_relaxed);
+
+		// the frame starts before the low-latency wait, which is timed as part of its fence wait; event callbacks are timed apart
+		frameStats.beginFrame();
+		framePacer.waitBeforeInput();
+		frameStats.endPhase(FramePhase::FenceWait);
+		glfwPollEvents();
+		frameStats.inputSampled();
+		frameStats.endPhase(FramePhase::Input);
+		drawFrame();
 	}
 	logicalDevice.waitIdle();
+	collectInFlightGpuQueries();
+	writeBenchmarkReport();
+
+	if (options.idle) {
+		endIdlePeriod();
+		fmt::print("idle mode: drew {} frames, idle for {:.3f} s\n", frameNumber, idleTime.count());
+	}
+}
+
+auto Application::endIdlePeriod() -> void
+{
+	if (not idleSince.has_value()) {
+		return;
+	}
+
+	idleTime += std::chrono::steady_clock::now() - *idleSince;
+	idleSince.reset();
+}
+
+auto Application::toggleAnimation() -> void
+{
+	// the scene only moves on the simulation thread, so without one there is nothing to pause
+	if (simulation) {
+		simulation->setPaused(not simulation->paused());
+	}
+}
+
+auto Application::benchmarkComplete() const -> bool { return options.benchFrames.has_value() and frameNumber >= *options.benchFrames; }
+
+// the camera follows the scene and the window's extent, so a moved scene or a resized, uncovered or recreated window covers it; so
+// does the model streaming in, which frames have to keep polling for
+auto Application::redrawNeeded() const -> bool
+{
+	return redrawRequested or framebufferResized or not assetsResident or sceneMoved.load(std::memory_order_relaxed);
+}
+
+auto Application::writeBenchmarkReport() const -> void
+{
+	if (not options.benchFrames.has_value()) {
+		return;
+	}
+
+	auto const properties = physicalDevice.getProperties();
+	auto const summary    = frameStats.summariseFrames();
+	auto const gpuSummary = frameStats.summariseGpuFrames();
+	frameStats.writeJson(options.benchOutput, properties.deviceName.data());
+
+	fmt::print("{} frames: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms, GPU p50 {:.3f} ms; report written to {}\n",
+	           frameStats.frameCount(),
+	           summary.p50,
+	           summary.p95,
+	           summary.p99,
+	           summary.max,
+	           gpuSummary.p50,
+	           options.benchOutput.string());
+
+	auto const record    = frameStats.summarisePhase(FramePhase::Record);
+	auto const recording = parallelRecorder ? fmt::format("on {} threads", parallelRecorder->threadCount()) : std::string{"inline"};
+	fmt::print("recorded {} draws a frame {}: p50 {:.3f} ms, p95 {:.3f} ms\n",
+	           mesh.submeshes().size() * options.drawCopies,
+	           recording,
+	           record.p50,
+	           record.p95);
+
+	// headless frames sample no input
+	if (not options.headless) {
+		auto const latency = frameStats.summariseInputLatency();
+		fmt::print("input to submit with {} frames in flight{}: p50 {:.3f} ms, p95 {:.3f} ms\n",
+		           framePacer.framesInFlight(),
+		           framePacer.lowLatency() ? ", low latency" : "",
+		           latency.p50,
+		           latency.p95);
+	}
+
+	auto const memory = allocator.statistics();
+	fmt::print("device memory: {} blocks, {} dedicated allocations, {} live allocations, {:.2f} of {:.2f} MiB in use\n",
+	           memory.blockCount,
+	           memory.dedicatedAllocationCount,
+	           memory.allocationCount,
+	           static_cast<double>(memory.usedBytes) / (1u << 20u),
+	           static_cast<double>(memory.reservedBytes) / (1u << 20u));
+}
+
+auto Application::animationTime() const -> float
+{
+	if (options.benchFrames.has_value()) {
+		return static_cast<float>(frameNumber) * BENCH_FRAME_PERIOD;
+	}
+
+	return std::chrono::duration<float>{std::chrono::steady_clock::now() - startTime}.count();
+}
+
+auto Application::sceneState() const -> SceneState
+{
+	if (simulation) {
+		return simulation->sample(Simulation::Clock::now());
+	}
+
+	return advance(SceneState{}, animationTime());
 }
 
 auto Application::makeInstance() const -> vkr::Instance
@@ -241,7 +498,7 @@ auto Application::makeInstance() const -> vkr::Instance
 	auto const applicationInfo =
 	    vk::ApplicationInfo{applicationName.data(), applicationVersion, engineName.data(), engineVersion, VK_API_VERSION_1_3};
 	auto const debugCreateInfo = makeDebugMessengerCreateInfoEXT();
-	auto const extensions      = getRequiredExtensions(enableValidationLayers);
+	auto const extensions      = getRequiredExtensions(enableValidationLayers, options.headless);
 
 	if (enableValidationLayers) {
 		auto const instanceCreateInfo = vk::InstanceCreateInfo{{}, &applicationInfo, validationLayers, extensions, &debugCreateInfo};
@@ -261,6 +518,10 @@ auto Application::makeDebugMessenger() const -> vkr::DebugUtilsMessengerEXT
 
 auto Application::makeSurface() -> vkr::SurfaceKHR
 {
+	if (options.headless) {
+		return nullptr;
+	}
+
 	if (auto const result = glfwCreateWindowSurface(*instance, window.get(), nullptr, &sfc); result != VK_SUCCESS) {
 		throw std::runtime_error("failed to create window surface");
 	}
@@ -271,8 +532,9 @@ auto Application::makeSurface() -> vkr::SurfaceKHR
 auto Application::pickPhysicalDevice() -> vkr::PhysicalDevice
 {
 	static auto const physicalDevices = vkr::PhysicalDevices(instance);
-	auto const        physDevice =
-	    std::ranges::find_if(physicalDevices, [this](auto const& physDev) { return isDeviceSuitable(physDev, surface, requiredDeviceExtensions); });
+	auto const        physDevice = std::ranges::find_if(physicalDevices,
+                                                 [this](auto const& physDev)
+                                                 { return isDeviceSuitable(physDev, surface, getRequiredDeviceExtensions(options.headless)); });
 
 	if (physDevice == std::end(physicalDevices)) {
 		throw std::runtime_error("failed to find a suitable GPU");
@@ -285,7 +547,9 @@ auto Application::makeDevice() const -> vkr::Device
 {
 	constexpr auto queuePriorities     = std::array{1.0f};
 	auto           queueCreateInfos    = std::vector<vk::DeviceQueueCreateInfo>{};
-	auto           uniqueQueueFamilies = std::set{queueFamilyIndices.graphicsFamily.value(), queueFamilyIndices.presentFamily.value()};
+	auto           uniqueQueueFamilies = std::set{queueFamilyIndices.graphicsFamily.value(),
+	                                              queueFamilyIndices.presentFamily.value(),
+	                                              queueFamilyIndices.transferFamily.value()};
 
 	std::ranges::transform(uniqueQueueFamilies,
 	                       std::back_inserter(queueCreateInfos),
@@ -293,26 +557,43 @@ auto Application::makeDevice() const -> vkr::Device
 		                       return {{}, queueFamily, queuePriorities};
 	                       });
 
-	auto deviceFeatures              = vk::PhysicalDeviceFeatures{};
-	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	auto deviceFeatures                    = vk::PhysicalDeviceFeatures{};
+	deviceFeatures.samplerAnisotropy       = VK_TRUE;
+	deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+	deviceFeatures.inheritedQueries        = supportedFeatures.inheritedQueries;
+	deviceFeatures.textureCompressionBC    = supportedFeatures.textureCompressionBC;
+	auto const extensions                  = getRequiredDeviceExtensions(options.headless);
+
+	auto vulkan12Features              = vk::PhysicalDeviceVulkan12Features{};
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+
+	if (options.gpuCulling) {
+		auto const supported12 = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>()
+		                             .get<vk::PhysicalDeviceVulkan12Features>();
+		if (not supported12.drawIndirectCount or not supportedFeatures.drawIndirectFirstInstance) {
+			throw std::runtime_error{"--gpu-culling needs the drawIndirectCount and drawIndirectFirstInstance features"};
+		}
+		deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+		vulkan12Features.drawIndirectCount       = VK_TRUE;
+	}
 
 	if (enableValidationLayers) {
-		auto const deviceCreateInfo{vk::DeviceCreateInfo{{}, queueCreateInfos, validationLayers, requiredDeviceExtensions, &deviceFeatures}};
+		auto const deviceCreateInfo{vk::DeviceCreateInfo{{}, queueCreateInfos, validationLayers, extensions, &deviceFeatures, &vulkan12Features}};
 		return physicalDevice.createDevice(deviceCreateInfo);
 	}
 
-	auto const deviceCreateInfo = vk::DeviceCreateInfo{{}, queueCreateInfos, {}, requiredDeviceExtensions, &deviceFeatures};
+	auto const deviceCreateInfo = vk::DeviceCreateInfo{{}, queueCreateInfos, {}, extensions, &deviceFeatures, &vulkan12Features};
 
 	return physicalDevice.createDevice(deviceCreateInfo);
 }
 
 auto Application::chooseSwapSurfaceFormat(std::span<vk::SurfaceFormatKHR const> availableFormats) -> vk::SurfaceFormatKHR
 {
-	static auto const format = std::ranges::find_if(availableFormats,
-	                                                [](auto const& availableFormat) {
-		                                                return availableFormat.format == vk::Format::eB8G8R8A8Srgb and
-		                                                       availableFormat.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear;
-	                                                });
+	auto const format = std::ranges::find_if(availableFormats,
+	                                         [](auto const& availableFormat) {
+		                                         return availableFormat.format == vk::Format::eB8G8R8A8Srgb and
+		                                                availableFormat.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear;
+	                                         });
 
 	if (format == std::end(availableFormats)) {
 		return availableFormats.front();
@@ -327,11 +608,11 @@ auto Application::chooseSwapExtent(GLFWWindowPointer const& window, vk::SurfaceC
 		return capabilities.currentExtent;
 	}
 
-	static int width;
-	static int height;
+	auto width{0};
+	auto height{0};
 	glfwGetFramebufferSize(window.get(), &width, &height);
 
-	static auto actualExtent = vk::Extent2D{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)};
+	auto actualExtent = vk::Extent2D{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)};
 
 	actualExtent.width  = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
 	actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
@@ -339,15 +620,21 @@ auto Application::chooseSwapExtent(GLFWWindowPointer const& window, vk::SurfaceC
 	return actualExtent;
 }
 
-auto Application::makeSwapchain() -> vkr::SwapchainKHR
+auto Application::makeSwapchain(vk::SwapchainKHR const oldSwapchain) -> vkr::SwapchainKHR
 {
+	if (options.headless) {
+		return nullptr;
+	}
+
 	auto const newSwapchainSupport = SwapchainSupportDetails{physicalDevice, surface};
 	swapchainSupport               = newSwapchainSupport;
 
 	auto const [format, colourSpace] = chooseSwapSurfaceFormat(swapchainSupport.formats);
-	auto const presentMode           = chooseSwapPresentMode(swapchainSupport.presentModes);
+	auto const presentMode           = chooseSwapPresentMode(swapchainSupport.presentModes, options.presentMode);
 	auto const extent                = chooseSwapExtent(window, swapchainSupport.capabilities);
-	auto const imageCount            = std::max(swapchainSupport.capabilities.minImageCount + 1, swapchainSupport.capabilities.maxImageCount);
+	auto const minImageCount         = swapchainSupport.capabilities.minImageCount;
+	auto const maxImageCount         = swapchainSupport.capabilities.maxImageCount;// zero when there is no limit
+	auto const imageCount            = maxImageCount == 0u ? minImageCount + 1u : std::min(minImageCount + 1u, maxImageCount);
 	auto const indices               = queueFamilyIndices.indices();
 	auto const swapchainCreateInfo   = vk::SwapchainCreateInfoKHR{
 	      {},
@@ -363,31 +650,87 @@ auto Application::makeSwapchain() -> vkr::SwapchainKHR
         swapchainSupport.capabilities.currentTransform,
         vk::CompositeAlphaFlagBitsKHR::eOpaque,
         presentMode,
-        VK_TRUE};
+        VK_TRUE,
+        oldSwapchain};
 
-	if (format != swapchainImageFormat or extent != swapchainExtent) {
-		swapchainImageFormat = format;
-		swapchainExtent      = extent;
-	}
+	// assigned rather than compared, since the first call comes before either member's initialiser has run
+	swapchainImageFormat = format;
+	swapchainExtent      = extent;
 
 	return logicalDevice.createSwapchainKHR(swapchainCreateInfo);
 }
 
+auto Application::chooseImageFormat() const -> vk::Format
+{
+	if (options.headless) {
+		return OFFSCREEN_FORMAT;
+	}
+
+	return chooseSwapSurfaceFormat(swapchainSupport.formats).format;
+}
+
+auto Application::chooseImageExtent() const -> vk::Extent2D
+{
+	if (options.headless) {
+		return {options.width, options.height};
+	}
+
+	return chooseSwapExtent(window, swapchainSupport.capabilities);
+}
+
+auto Application::makeOffscreenImages() const -> std::vector<ImageAndMemory>
+{
+	auto images = std::vector<ImageAndMemory>{};
+	if (not options.headless) {
+		return images;
+	}
+
+	images.reserve(framesInFlight);
+	std::ranges::generate_n(std::back_inserter(images),
+	                        framesInFlight,
+	                        [this]
+	                        {
+		                        return makeImageAndMemory(swapchainExtent.width,
+		                                                  swapchainExtent.height,
+		                                                  1u,
+		                                                  swapchainImageFormat,
+		                                                  vk::ImageTiling::eOptimal,
+		                                                  vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+		                                                  vk::MemoryPropertyFlagBits::eDeviceLocal);
+	                        });
+
+	return images;
+}
+
 auto Application::makeImageViews() -> std::vector<vkr::ImageView>
 {
 	auto imageViews = std::vector<vkr::ImageView>{};
+
+	if (options.headless) {
+		imageViews.reserve(offscreenImages.size());
+		std::ranges::transform(offscreenImages,
+		                       std::back_inserter(imageViews),
+		                       [this](auto const& imageAndMemory) -> vkr::ImageView
+		                       { return makeImageView(*imageAndMemory.image, swapchainImageFormat, vk::ImageAspectFlagBits::eColor, 1u); });
+
+		return imageViews;
+	}
+
 	imageViews.reserve(swapchain.getImages().size());
 	std::ranges::transform(swapchain.getImages(),
 	                       std::back_inserter(imageViews),
 	                       [this](auto const& image) -> vkr::ImageView
-	                       { return makeImageView(image, swapchainImageFormat, vk::ImageAspectFlagBits::eColor); });
+	                       { return makeImageView(image, swapchainImageFormat, vk::ImageAspectFlagBits::eColor, 1u); });
 
 	return imageViews;
 }
 
-auto Application::makeImageView(vk::Image const& image, vk::Format const& format, vk::ImageAspectFlags const& aspectFlags) const -> vkr::ImageView
+auto Application::makeImageView(vk::Image const&            image,
+                                vk::Format const&           format,
+                                vk::ImageAspectFlags const& aspectFlags,
+                                std::uint32_t const         mipLevels) const -> vkr::ImageView
 {
-	auto const imageCreateInfo = vk::ImageViewCreateInfo{{}, image, vk::ImageViewType::e2D, format, {}, {aspectFlags, 0, 1, 0, 1}};
+	auto const imageCreateInfo = vk::ImageViewCreateInfo{{}, image, vk::ImageViewType::e2D, format, {}, {aspectFlags, 0, mipLevels, 0, 1}};
 
 	return logicalDevice.createImageView(imageCreateInfo);
 }
@@ -423,7 +766,7 @@ auto Application::makeRenderPass() const -> vkr::RenderPass
                                                             vk::AttachmentLoadOp::eDontCare,
                                                             vk::AttachmentStoreOp::eDontCare,
                                                             vk::ImageLayout::eUndefined,
-                                                            vk::ImageLayout::ePresentSrcKHR};
+                                                            options.headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR};
 	constexpr auto colourAttachmentRef = vk::AttachmentReference{{0}, vk::ImageLayout::eColorAttachmentOptimal};
 
 	auto const     depthAttachment    = vk::AttachmentDescription{{},
@@ -446,7 +789,22 @@ auto Application::makeRenderPass() const -> vkr::RenderPass
 	                          {},
 	                          vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite};
 
-	auto const attachments    = std::array{colourAttachment, depthAttachment};
+	auto const attachments = std::array{colourAttachment, depthAttachment};
+
+	if (options.headless) {
+		// make colour writes visible to the readback copy recorded after the render pass
+		constexpr auto readbackDependency = vk::SubpassDependency{0u,
+		                                                          VK_SUBPASS_EXTERNAL,
+		                                                          vk::PipelineStageFlagBits::eColorAttachmentOutput,
+		                                                          vk::PipelineStageFlagBits::eTransfer,
+		                                                          vk::AccessFlagBits::eColorAttachmentWrite,
+		                                                          vk::AccessFlagBits::eTransferRead};
+		auto const     dependencies       = std::array{dependency, readbackDependency};
+		auto const     renderPassInfo     = vk::RenderPassCreateInfo{{}, attachments, subpass, dependencies};
+
+		return logicalDevice.createRenderPass(renderPassInfo);
+	}
+
 	auto const renderPassInfo = vk::RenderPassCreateInfo{{}, attachments, subpass, dependency};
 
 	return logicalDevice.createRenderPass(renderPassInfo);
@@ -454,22 +812,32 @@ auto Application::makeRenderPass() const -> vkr::RenderPass
 
 auto Application::makeDescriptorSetLayout() const -> vkr::DescriptorSetLayout
 {
-	constexpr auto mvprojLayoutBinding = vk::DescriptorSetLayoutBinding{0u, vk::DescriptorType::eUniformBuffer, 1u, vk::ShaderStageFlagBits::eVertex};
+	constexpr auto cameraLayoutBinding =
+	    vk::DescriptorSetLayoutBinding{0u, vk::DescriptorType::eUniformBufferDynamic, 1u, vk::ShaderStageFlagBits::eVertex};
 	constexpr auto samplerLayoutBinding =
 	    vk::DescriptorSetLayoutBinding{1u, vk::DescriptorType::eCombinedImageSampler, 1u, vk::ShaderStageFlagBits::eFragment};
-	constexpr auto layoutBindings = std::array{mvprojLayoutBinding, samplerLayoutBinding};
-	auto const     layoutInfo     = vk::DescriptorSetLayoutCreateInfo{{}, layoutBindings};
+	constexpr auto instanceLayoutBinding =
+	    vk::DescriptorSetLayoutBinding{2u, vk::DescriptorType::eStorageBuffer, 1u, vk::ShaderStageFlagBits::eVertex};
+	constexpr auto layoutBindings        = std::array{cameraLayoutBinding, samplerLayoutBinding, instanceLayoutBinding};
+	auto const     layoutInfo            = vk::DescriptorSetLayoutCreateInfo{{}, layoutBindings};
 
 	return logicalDevice.createDescriptorSetLayout(layoutInfo);
 }
 
-auto Application::makeGraphicsPipeline() const -> PipelineLayoutAndPipeline
+// the SPIR-V is compiled into the executable; a shader directory replaces it without relinking
+auto Application::loadShader(fs::path const& fileName, std::span<std::uint32_t const> const embedded) const -> vkr::ShaderModule
 {
-	auto const     vertShaderCode = readFile("triangle.vert.spv"sv);
-	auto const     fragShaderCode = readFile("triangle.frag.spv"sv);
+	if (options.shaderDirectory) {
+		return makeShaderModule(readFile(*options.shaderDirectory / fileName));
+	}
 
-	auto const     vertShaderModule = makeShaderModule(vertShaderCode);
-	auto const     fragShaderModule = makeShaderModule(fragShaderCode);
+	return makeShaderModule(std::as_bytes(embedded));
+}
+
+auto Application::makeGraphicsPipeline() const -> PipelineLayoutAndPipeline
+{
+	auto const     vertShaderModule = loadShader("triangle.vert.spv"sv, Shaders::TRIANGLE_VERT);
+	auto const     fragShaderModule = loadShader("triangle.frag.spv"sv, Shaders::TRIANGLE_FRAG);
 
 	auto const     vertShaderStageInfo = vk::PipelineShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eVertex, *vertShaderModule, "main"};
 	auto const     fragShaderStageInfo = vk::PipelineShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eFragment, *fragShaderModule, "main"};
@@ -478,8 +846,8 @@ auto Application::makeGraphicsPipeline() const -> PipelineLayoutAndPipeline
 	constexpr auto dynamicStates = std::array{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
 	auto const     dynamicState  = vk::PipelineDynamicStateCreateInfo{{}, dynamicStates};
 
-	constexpr auto bindingDescription   = Vertex::getBindingDescription();
-	constexpr auto attributeDescription = Vertex::getAttributeDescriptions();
+	constexpr auto bindingDescription   = MeshVertex::getBindingDescription();
+	constexpr auto attributeDescription = MeshVertex::getAttributeDescriptions();
 	auto const     vertexInputInfo      = vk::PipelineVertexInputStateCreateInfo{{}, bindingDescription, attributeDescription};
 
 	constexpr auto inputAssembly = vk::PipelineInputAssemblyStateCreateInfo{{}, vk::PrimitiveTopology::eTriangleList};
@@ -530,7 +898,7 @@ auto Application::makeGraphicsPipeline() const -> PipelineLayoutAndPipeline
 	                                                                      {},
                                                              -1};
 
-	auto           retGraphicsPipeline = logicalDevice.createGraphicsPipeline(nullptr, pipelineInfo);
+	auto           retGraphicsPipeline = logicalDevice.createGraphicsPipeline(pipelineCache.get(), pipelineInfo);
 
 	return {std::move(retPipelineLayout), std::move(retGraphicsPipeline)};
 }
@@ -538,7 +906,7 @@ auto Application::makeGraphicsPipeline() const -> PipelineLayoutAndPipeline
 auto Application::makeFramebuffers() -> std::vector<vkr::Framebuffer>
 {
 	auto framebuffers = std::vector<vkr::Framebuffer>{};
-	framebuffers.reserve(MAX_FRAMES_IN_FLIGHT);
+	framebuffers.reserve(framesInFlight);
 
 	std::ranges::transform(
 	    swapchainImageViews,
@@ -565,27 +933,134 @@ auto Application::makeCommandPool() const -> vkr::CommandPool
 
 auto Application::makeCommandBuffers() const -> vkr::CommandBuffers
 {
-	auto const allocInfo = vk::CommandBufferAllocateInfo{*commandPool, vk::CommandBufferLevel::ePrimary, MAX_FRAMES_IN_FLIGHT};
+	auto const allocInfo = vk::CommandBufferAllocateInfo{*commandPool, vk::CommandBufferLevel::ePrimary, framesInFlight};
 
 	return {logicalDevice, allocInfo};
 }
 
-auto Application::recordCommandBuffer(vkr::CommandBuffer const& commandBuffer, std::uint32_t const imageIndex) -> void
+auto Application::makeParallelRecorder() const -> std::unique_ptr<ParallelRecorder>
+{
+	if (options.recordThreads == 0u) {
+		return nullptr;
+	}
+
+	return std::make_unique<ParallelRecorder>(logicalDevice, queueFamilyIndices.graphicsFamily.value(), framesInFlight, options.recordThreads);
+}
+
+auto Application::makeFrustumCuller() const -> std::unique_ptr<FrustumCuller>
+{
+	if (not options.gpuCulling) {
+		return nullptr;
+	}
+
+	auto const shaderModule = loadShader("cull.comp.spv"sv, Shaders::CULL_COMP);
+	auto const bounds       = boundingSphere(mesh.vertices());
+	auto const scene        = FrustumCuller::Scene{*instanceBufferAndMemory.buffer, options.instanceCount, mesh.submeshes(), bounds};
+
+	return std::make_unique<FrustumCuller>(logicalDevice, allocator, pipelineCache.get(), shaderModule, framesInFlight, scene);
+}
+
+auto Application::makeSimulation() -> std::unique_ptr<Simulation>
+{
+	if (options.simulationRate == 0u or options.benchFrames.has_value()) {
+		return nullptr;
+	}
+
+	if (not options.idle) {
+		return std::make_unique<Simulation>(options.simulationRate);
+	}
+
+	// glfwPostEmptyEvent may be called from any thread
+	return std::make_unique<Simulation>(options.simulationRate, [this] {
+		sceneMoved.store(true, std::memory_order_relaxed);
+		glfwPostEmptyEvent();
+	});
+}
+
+auto Application::recordCommandBuffer(vkr::CommandBuffer const& commandBuffer, std::uint32_t const imageIndex, ViewProjection const& camera)
+    -> void
 {
 	constexpr auto beginInfo = vk::CommandBufferBeginInfo{};
 	commandBuffer.begin(beginInfo);
 
+	auto const& queries = queryPools.at(framePacer.frame());
+	if (*queries.timestamps) {
+		commandBuffer.resetQueryPool(*queries.timestamps, 0u, 2u);
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *queries.timestamps, 0u);
+	}
+	if (*queries.statistics) {
+		commandBuffer.resetQueryPool(*queries.statistics, 0u, 1u);
+		commandBuffer.beginQuery(*queries.statistics, 0u, {});
+	}
+
+	acquireStreamedAssets(commandBuffer);
+
+	// culling has to finish before the render pass begins, and has nothing to cull until the model is resident
+	if (frustumCuller and assetsResident) {
+		frustumCuller->recordCulling(commandBuffer, framePacer.frame(), camera.projection * camera.view);
+	}
+
 	constexpr auto clearColours =
 	    std::array{vk::ClearValue{vk::ClearColorValue{0.0f, 0.0f, 0.0f, 1.0f}}, vk::ClearValue{vk::ClearDepthStencilValue{1.0f, 0u}}};
 	auto const renderPassInfo = vk::RenderPassBeginInfo{*renderPass, *swapchainFramebuffers.at(imageIndex), {{}, swapchainExtent}, clearColours};
 
-	commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-	commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *layoutAndPipeline.pipeline);
+	auto const drawCount = assetsResident ? mesh.submeshes().size() * options.drawCopies : std::size_t{0};
+	if (parallelRecorder) {
+		// statistics queries only count secondaries that inherit them
+		auto inheritanceInfo = vk::CommandBufferInheritanceInfo{*renderPass, 0u, *swapchainFramebuffers.at(imageIndex)};
+		if (*queries.statistics) {
+			inheritanceInfo.pipelineStatistics = pipelineStatisticFlags;
+		}
 
-	constexpr auto offset = vk::DeviceSize{0};
+		auto const recordShare = [this](vkr::CommandBuffer const& secondary, std::size_t const first, std::size_t const count)
+		{ recordDraws(secondary, first, count); };
+		auto const secondaries = parallelRecorder->record(framePacer.frame(), inheritanceInfo, drawCount, recordShare);
+
+		commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+		commandBuffer.executeCommands(secondaries);
+	} else if (frustumCuller) {
+		commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+		bindDrawState(commandBuffer);
+		if (assetsResident) {
+			frustumCuller->recordDraws(commandBuffer, framePacer.frame());
+		}
+	} else {
+		commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+		recordDraws(commandBuffer, 0u, drawCount);
+	}
+	commandBuffer.endRenderPass();
 
-	commandBuffer.bindVertexBuffers(0u, *vertexBufferAndMemory.buffer, offset);
-	commandBuffer.bindIndexBuffer(*indexBufferAndMemory.buffer, 0, vk::IndexType::eUint32);
+	if (*queries.statistics) {
+		commandBuffer.endQuery(*queries.statistics, 0u);
+	}
+	if (*queries.timestamps) {
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *queries.timestamps, 1u);
+	}
+
+	if (not readbackBuffersAndMemories.empty()) {
+		auto const region = vk::BufferImageCopy{0u,
+		                                        0u,
+		                                        0u,
+		                                        vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u},
+		                                        {0, 0, 0},
+		                                        {swapchainExtent.width, swapchainExtent.height, 1u}};
+		commandBuffer.copyImageToBuffer(*offscreenImages.at(imageIndex).image,
+		                                vk::ImageLayout::eTransferSrcOptimal,
+		                                *readbackBuffersAndMemories.at(framePacer.frame()).buffer,
+		                                region);
+
+		constexpr auto hostReadBarrier = vk::MemoryBarrier{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead};
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, hostReadBarrier, {}, {});
+	}
+
+	commandBuffer.end();
+}
+
+// the pipeline and dynamic state, then the model's buffers and descriptor sets once it is resident; secondary command buffers inherit
+// none of it, and they call this concurrently from the recording threads, so it must only read
+auto Application::bindDrawState(vkr::CommandBuffer const& commandBuffer) const -> void
+{
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *layoutAndPipeline.pipeline);
 
 	auto const viewport = vk::Viewport{0.0f, 0.0f, static_cast<float>(swapchainExtent.width), static_cast<float>(swapchainExtent.height), 0.0f, 1.0f};
 	commandBuffer.setViewport(0, viewport);
@@ -593,78 +1068,257 @@ auto Application::recordCommandBuffer(vkr::CommandBuffer const& commandBuffer, s
 	auto const scissor = vk::Rect2D{{}, swapchainExtent};
 	commandBuffer.setScissor(0, scissor);
 
-	commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *layoutAndPipeline.layout, {}, *descriptorSets[currentFrameIndex], {});
+	if (not assetsResident) {
+		return;
+	}
 
-	commandBuffer.drawIndexed(verticesAndIndices.vertices.size(), 1, 0, 0, 0);
-	commandBuffer.endRenderPass();
-	commandBuffer.end();
+	constexpr auto offset = vk::DeviceSize{0};
+
+	commandBuffer.bindVertexBuffers(0u, *vertexBufferAndMemory.buffer, offset);
+	commandBuffer.bindIndexBuffer(*indexBufferAndMemory.buffer, 0, MESH_INDEX_TYPE);
+	commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *layoutAndPipeline.layout, {}, *descriptorSet, cameraUniformOffset);
 }
 
-auto Application::drawFrame() -> void
+// draws [first, first + count) of the submesh list repeated drawCopies times
+auto Application::recordDraws(vkr::CommandBuffer const& commandBuffer, std::size_t const first, std::size_t const count) const -> void
 {
-	if (auto const waitResult =
-	        logicalDevice.waitForFences(*inFlightFences.at(currentFrameIndex), VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-	    waitResult != vk::Result::eSuccess)
-	{
-		throw std::runtime_error("Failed to wait for fences");
+	bindDrawState(commandBuffer);
+
+	auto const submeshes = mesh.submeshes();
+	for (auto const draw : rv::iota(first, first + count)) {
+		auto const& [firstIndex, indexCount, vertexOffset] = submeshes[draw % submeshes.size()];
+		commandBuffer.drawIndexed(indexCount, options.instanceCount, firstIndex, vertexOffset, 0u);
+	}
+}
+
+auto Application::acquireStreamedAssets(vkr::CommandBuffer const& commandBuffer) -> void
+{
+	// polled rather than waited on, so the frame loop keeps going while the transfer queue works
+	if (assetsResident or not uploader.isComplete(assetUploadValue)) {
+		return;
+	}
+
+	uploader.acquire(assetUploadValue, commandBuffer);
+	uploadWaitValue = assetUploadValue;
+	assetsResident  = true;
+}
+
+auto Application::submitFrame(vk::Semaphore const& waitSemaphore, vk::Semaphore const& signalSemaphore) -> void
+{
+	auto waitSemaphores = std::array<vk::Semaphore, 2>{};
+	auto waitStages     = std::array<vk::PipelineStageFlags, 2>{};
+	auto waitValues     = std::array<std::uint64_t, 2>{};
+	auto waitCount      = 0u;
+
+	if (waitSemaphore) {
+		waitSemaphores.at(waitCount) = waitSemaphore;
+		waitStages.at(waitCount)     = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		++waitCount;
+	}
+	// the frame that acquires streamed resources must also wait for the transfer queue to release them
+	if (uploadWaitValue.has_value()) {
+		waitSemaphores.at(waitCount) = uploader.semaphore();
+		waitStages.at(waitCount)     = vk::PipelineStageFlagBits::eAllCommands;
+		waitValues.at(waitCount)     = *uploadWaitValue;
+		++waitCount;
+	}
+
+	auto const usedWaitSemaphores = std::span{waitSemaphores}.first(waitCount);
+	auto const usedWaitStages     = std::span{waitStages}.first(waitCount);
+	auto const usedWaitValues     = std::span{waitValues}.first(waitCount);
+	auto const signalSemaphores   = signalSemaphore ? std::span{&signalSemaphore, 1u} : std::span<vk::Semaphore const>{};
+	auto const timelineInfo       = vk::TimelineSemaphoreSubmitInfo{usedWaitValues, {}};
+	auto const submitInfo =
+	    vk::SubmitInfo{usedWaitSemaphores, usedWaitStages, *commandBuffers.at(framePacer.frame()), signalSemaphores, &timelineInfo};
+
+	graphicsQueue.submit(submitInfo, framePacer.fence());
+	frameStats.submitted();
+	uploadWaitValue.reset();
+}
+
+auto Application::findTimestampValidBits() const -> std::uint32_t
+{
+	return physicalDevice.getQueueFamilyProperties().at(queueFamilyIndices.graphicsFamily.value()).timestampValidBits;
+}
+
+auto Application::makeQueryPools() const -> std::vector<FrameQueryPools>
+{
+	auto const timestampPoolInfo  = vk::QueryPoolCreateInfo{{}, vk::QueryType::eTimestamp, 2u};
+	auto const statisticsPoolInfo = vk::QueryPoolCreateInfo{{}, vk::QueryType::ePipelineStatistics, 1u, pipelineStatisticFlags};
+	// a statistics query spanning secondary command buffers needs them to inherit it
+	auto const statistics         = supportedFeatures.pipelineStatisticsQuery and (not parallelRecorder or supportedFeatures.inheritedQueries);
+	auto       pools              = std::vector<FrameQueryPools>{};
+	pools.reserve(framesInFlight);
+
+	std::ranges::generate_n(std::back_inserter(pools),
+	                        framesInFlight,
+	                        [&]() -> FrameQueryPools
+	                        {
+		                        return {timestampValidBits > 0u ? logicalDevice.createQueryPool(timestampPoolInfo) : vkr::QueryPool{nullptr},
+		                                statistics ? logicalDevice.createQueryPool(statisticsPoolInfo) : vkr::QueryPool{nullptr}};
+	                        });
+
+	return pools;
+}
+
+auto Application::collectGpuQueries(std::uint32_t const frameIndex) -> void
+{
+	// only called once the frame's fence has signalled, so the results are ready and this never stalls
+	auto& queries = queryPools.at(frameIndex);
+	if (not queries.pending) {
+		return;
+	}
+	queries.pending = false;
+
+	auto gpuFrame = GpuFrameStats{};
+
+	if (*queries.timestamps) {
+		auto const [result, timestamps] =
+		    queries.timestamps.getResults<std::uint64_t>(0u, 2u, 2u * sizeof(std::uint64_t), sizeof(std::uint64_t), vk::QueryResultFlagBits::e64);
+		if (result != vk::Result::eSuccess) {
+			return;
+		}
+
+		auto const mask          = timestampValidBits >= 64u ? ~std::uint64_t{0} : (std::uint64_t{1} << timestampValidBits) - 1u;
+		auto const ticks         = (timestamps.at(1) - timestamps.at(0)) & mask;
+		gpuFrame.gpuMilliseconds = static_cast<double>(ticks) * static_cast<double>(timestampPeriod) / 1.0e6;
+	}
+
+	if (*queries.statistics) {
+		constexpr auto statisticCount = 4u;
+		auto const [result, statistics] = queries.statistics.getResults<std::uint64_t>(0u,
+		                                                                               1u,
+		                                                                               statisticCount * sizeof(std::uint64_t),
+		                                                                               statisticCount * sizeof(std::uint64_t),
+		                                                                               vk::QueryResultFlagBits::e64);
+		if (result != vk::Result::eSuccess) {
+			return;
+		}
+
+		// results are ordered by flag bit
+		gpuFrame.vertexShaderInvocations   = statistics.at(0);
+		gpuFrame.clippingInvocations       = statistics.at(1);
+		gpuFrame.clippingPrimitives        = statistics.at(2);
+		gpuFrame.fragmentShaderInvocations = statistics.at(3);
 	}
 
-	auto const [acquireResult, imageIndex] =
-	    swapchain.acquireNextImage(std::numeric_limits<std::uint64_t>::max(), *imageAvailableSemaphores.at(currentFrameIndex));
+	frameStats.recordGpuFrame(gpuFrame);
+}
+
+// once the device is idle, for the frames still in flight when the loop ended; oldest first, so the latest frame's results are kept
+auto Application::collectInFlightGpuQueries() -> void
+{
+	for (auto const i : rv::iota(0u, framesInFlight)) {
+		collectGpuQueries((framePacer.frame() + i) % framesInFlight);
+	}
+}
+
+auto Application::drawFrame() -> void
+{
+	auto const frame = framePacer.frame();
+	framePacer.waitForFrame();
+	frameStats.endPhase(FramePhase::FenceWait);
+	collectGpuQueries(frame);
+	retiredSwapchains.at(frame).clear();
+	uploader.collect();
+
+	auto acquireResult = vk::Result{};
+	auto imageIndex    = 0u;
+	try {
+		std::tie(acquireResult, imageIndex) =
+		    swapchain.acquireNextImage(std::numeric_limits<std::uint64_t>::max(), *imageAvailableSemaphores.at(frame));
+	} catch (vk::OutOfDateKHRError const&) {
+		// nothing is submitted this frame, so the previous frame is the last to use the old swapchain; the fence stays signalled
+		framebufferResized = false;
+		remakeSwapchain(framePacer.previousFrame());
+		return;
+	}
 	if (acquireResult != vk::Result::eSuccess and acquireResult != vk::Result::eSuboptimalKHR) {
 		throw std::runtime_error{"Failed to acquire swapchain image"};
 	}
+	frameStats.endPhase(FramePhase::Acquire);
 
-	logicalDevice.resetFences(*inFlightFences.at(currentFrameIndex));
-
-	commandBuffers.at(currentFrameIndex).reset();
-	recordCommandBuffer(commandBuffers.at(currentFrameIndex), imageIndex);
+	framePacer.resetFence();
 
-	auto const&    waitSemaphores       = *imageAvailableSemaphores.at(currentFrameIndex);
-	auto const&    signalSemaphores     = *renderFinishedSemaphores.at(currentFrameIndex);
-	auto const&    submitCommandBuffers = *commandBuffers.at(currentFrameIndex);
-	constexpr auto waitStages           = vk::Flags{vk::PipelineStageFlagBits::eColorAttachmentOutput};
+	auto const camera = updateUniformBuffer(frame);
+	commandBuffers.at(frame).reset();
+	recordCommandBuffer(commandBuffers.at(frame), imageIndex, camera);
 
-	updateUniformBuffer(currentFrameIndex);
+	auto const& waitSemaphores   = *imageAvailableSemaphores.at(frame);
+	auto const& signalSemaphores = *renderFinishedSemaphores.at(frame);
+	frameStats.endPhase(FramePhase::Record);
 
-	auto const submitInfo = vk::SubmitInfo{waitSemaphores, waitStages, submitCommandBuffers, signalSemaphores};
-	graphicsQueue.submit(submitInfo, *inFlightFences.at(currentFrameIndex));
+	submitFrame(waitSemaphores, signalSemaphores);
+	queryPools.at(frame).pending = true;
+	frameStats.endPhase(FramePhase::Submit);
 
-	if (auto const presentResult = presentQueue.presentKHR(vk::PresentInfoKHR{signalSemaphores, *swapchain, imageIndex});
-	    presentResult == vk::Result::eSuboptimalKHR or framebufferResized)
-	{
+	auto presentResult = vk::Result{};
+	try {
+		presentResult = presentQueue.presentKHR(vk::PresentInfoKHR{signalSemaphores, *swapchain, imageIndex});
+	} catch (vk::OutOfDateKHRError const&) {
+		presentResult = vk::Result::eErrorOutOfDateKHR;
+	}
+	if (presentResult == vk::Result::eSuboptimalKHR or presentResult == vk::Result::eErrorOutOfDateKHR or framebufferResized) {
 		framebufferResized = false;
-		remakeSwapchain();
+		remakeSwapchain(frame);
 	} else if (presentResult != vk::Result::eSuccess) {
 		throw std::runtime_error("failed to present swapchain image");
 	}
+	frameStats.endPhase(FramePhase::Present);
+	frameStats.endFrame();
 
-	++currentFrameIndex;
-	currentFrameIndex %= MAX_FRAMES_IN_FLIGHT;
+	++frameNumber;
+	framePacer.advance();
+}
+
+auto Application::drawOffscreenFrame() -> void
+{
+	frameStats.beginFrame();
+
+	auto const frame = framePacer.frame();
+	framePacer.waitForFrame();
+	frameStats.endPhase(FramePhase::FenceWait);
+	collectGpuQueries(frame);
+	uploader.collect();
+
+	// writing frames to disk is not part of rendering, and there is nothing to acquire
+	writeReadback(frame);
+	frameStats.skipElapsed();
+	frameStats.endPhase(FramePhase::Acquire);
+
+	framePacer.resetFence();
+
+	auto const camera = updateUniformBuffer(frame);
+	commandBuffers.at(frame).reset();
+	recordCommandBuffer(commandBuffers.at(frame), frame, camera);
+	frameStats.endPhase(FramePhase::Record);
+
+	submitFrame({}, {});
+	queryPools.at(frame).pending = true;
+	frameStats.endPhase(FramePhase::Submit);
+	frameStats.endPhase(FramePhase::Present);
+	frameStats.endFrame();
+
+	if (not readbackBuffersAndMemories.empty()) {
+		pendingReadbacks.at(frame) = frameNumber;
+	}
+
+	++frameNumber;
+	framePacer.advance();
 }
 
 auto Application::makeSemaphores() const -> std::vector<vkr::Semaphore>
 {
 	constexpr auto semaphoreInfo = vk::SemaphoreCreateInfo{};
 	auto           semaphores    = std::vector<vkr::Semaphore>{};
-	semaphores.reserve(MAX_FRAMES_IN_FLIGHT);
+	semaphores.reserve(framesInFlight);
 
-	std::ranges::generate_n(std::back_inserter(semaphores), MAX_FRAMES_IN_FLIGHT, [&] { return vkr::Semaphore{logicalDevice, semaphoreInfo}; });
+	std::ranges::generate_n(std::back_inserter(semaphores), framesInFlight, [&] { return vkr::Semaphore{logicalDevice, semaphoreInfo}; });
 
 	return semaphores;
 }
 
-auto Application::makeFences() const -> std::vector<vkr::Fence>
-{
-	constexpr auto fenceInfo = vk::FenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
-	auto           fences    = std::vector<vkr::Fence>{};
-	fences.reserve(MAX_FRAMES_IN_FLIGHT);
-	std::ranges::generate_n(std::back_inserter(fences), MAX_FRAMES_IN_FLIGHT, [&] { return logicalDevice.createFence(fenceInfo); });
-
-	return fences;
-}
-
-auto Application::remakeSwapchain() -> void
+auto Application::remakeSwapchain(std::uint32_t const lastSubmittedFrame) -> void
 {
 	auto newWidth{0};
 	auto newHeight{0};
@@ -675,26 +1329,24 @@ auto Application::remakeSwapchain() -> void
 		glfwWaitEvents();
 	}
 
-	logicalDevice.waitIdle();
-
-	swapchainFramebuffers.clear();
-	swapchainImageViews.clear();
-	swapchain.clear();
-
-	swapchain             = makeSwapchain();
+	// frames still in flight may be drawing into the old images, so rather than waiting for the device to go idle everything sized
+	// to them is kept until the fence of the last frame submitted with them signals, which orders after every earlier submission;
+	// handing the old swapchain over lets the presentation engine go on showing its images while the new ones are created
+	auto retired = RetiredSwapchain{std::move(swapchain),
+	                                std::move(swapchainImageViews),
+	                                std::move(swapchainFramebuffers),
+	                                std::move(depthImageAndMemory),
+	                                std::move(depthImageView)};
+
+	swapchain             = makeSwapchain(*retired.swapchain);
+	depthImageAndMemory   = makeDepthImage();
+	depthImageView        = makeDepthImageView();
 	swapchainImageViews   = makeImageViews();
 	swapchainFramebuffers = makeFramebuffers();
-}
+	// nothing has been presented from the new images yet, which idle mode would otherwise leave blank
+	redrawRequested       = true;
 
-auto Application::findMemoryType(std::uint32_t const typeFilter, vk::MemoryPropertyFlags const& flags) const -> std::uint32_t
-{
-	for (auto const memProperties{physicalDevice.getMemoryProperties()}; auto const i : rv::iota(0u, memProperties.memoryTypeCount)) {
-		if (typeFilter & (1 << i) and (memProperties.memoryTypes.at(i).propertyFlags & flags) == flags) {
-			return i;
-		}
-	}
-
-	throw std::runtime_error("failed to find suitable memory type");
+	retiredSwapchains.at(lastSubmittedFrame).push_back(std::move(retired));
 }
 
 auto Application::makeBufferAndMemory(vk::DeviceSize const size, vk::BufferUsageFlags const& usage, vk::MemoryPropertyFlags const& properties) const
@@ -702,149 +1354,171 @@ auto Application::makeBufferAndMemory(vk::DeviceSize const size, vk::BufferUsage
 {
 	auto const bufferInfo = vk::BufferCreateInfo{{}, size, usage};
 	auto       retBuffer  = logicalDevice.createBuffer(bufferInfo);
+	auto       allocation = allocator.allocateFor(retBuffer, properties);
 
-	auto const memoryRequirements = retBuffer.getMemoryRequirements();
-	auto const allocInfo          = vk::MemoryAllocateInfo{memoryRequirements.size, findMemoryType(memoryRequirements.memoryTypeBits, properties)};
-	auto       retBufferMemory    = logicalDevice.allocateMemory(allocInfo);
-	retBuffer.bindMemory(*retBufferMemory, 0);
-
-	return {std::move(retBuffer), std::move(retBufferMemory)};
+	return {std::move(retBuffer), std::move(allocation)};
 }
 
-auto Application::copyBuffer(vkr::Buffer const& srcBuffer, vkr::Buffer const& dstBuffer, vk::DeviceSize const size) const -> void
+auto Application::makeVertexBuffer(UploadBatch& uploads) const -> BufferAndMemory
 {
-	auto       commandBuffer = beginSingleTimeCommands();
-	auto const copyRegion    = vk::BufferCopy{{}, {}, size};
+	auto const vertices      = mesh.vertices();
+	auto const bufferSize    = vk::DeviceSize{vertices.size_bytes()};
+	auto const stagingBuffer = uploads.stage(std::as_bytes(vertices));
 
-	commandBuffer.copyBuffer(*srcBuffer, *dstBuffer, copyRegion);
+	auto [retVertBuffer, retVertAllocation] = makeBufferAndMemory(bufferSize,
+	                                                              vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+	                                                              vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-	endSingleTimeCommands(std::move(commandBuffer));
+	uploads.copyBuffer(stagingBuffer, *retVertBuffer, bufferSize);
+	return {std::move(retVertBuffer), std::move(retVertAllocation)};
 }
 
-auto Application::makeVertexBuffer() const -> BufferAndMemory
+auto Application::makeIndexBuffer(UploadBatch& uploads) const -> BufferAndMemory
 {
-	auto const& vertices = verticesAndIndices.vertices;
-	using vertexType = std::remove_cvref_t<decltype(vertices)>::value_type;
-
-	auto const bufferSize = sizeof(vertexType) * vertices.size();
-	auto const [stagingBuffer, stagingBufferMemory] =
-	    makeBufferAndMemory(bufferSize,
-	                        vk::BufferUsageFlagBits::eTransferSrc,
-	                        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-	auto const data = static_cast<std::add_pointer_t<vertexType>>(stagingBufferMemory.mapMemory(0, bufferSize));
-	std::ranges::uninitialized_copy(vertices, std::span{data, vertices.size()});
-	stagingBufferMemory.unmapMemory();
+	auto const indices       = mesh.indices();
+	auto const bufferSize    = vk::DeviceSize{indices.size_bytes()};
+	auto const stagingBuffer = uploads.stage(std::as_bytes(indices));
 
-	auto [retVertBuffer, retVertBufferMemory] = makeBufferAndMemory(bufferSize,
-	                                                                vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+	auto [retIndexBuffer, retIndexAllocation] = makeBufferAndMemory(bufferSize,
+	                                                                vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
 	                                                                vk::MemoryPropertyFlagBits::eDeviceLocal);
+	uploads.copyBuffer(stagingBuffer, *retIndexBuffer, bufferSize);
 
-	copyBuffer(stagingBuffer, retVertBuffer, bufferSize);
-	return {std::move(retVertBuffer), std::move(retVertBufferMemory)};
+	return {std::move(retIndexBuffer), std::move(retIndexAllocation)};
 }
 
-auto Application::makeIndexBuffer() const -> BufferAndMemory
+// the frame's uniform blocks start over at the beginning of its region in the ring
+auto Application::updateUniformBuffer(std::uint32_t const currentImage) -> ViewProjection
 {
-	auto const& indices = verticesAndIndices.vertexIndices;
-	using vertexIndexType = std::remove_cvref_t<decltype(indices)>::value_type;
+	uniformRing.beginFrame(currentImage);
 
-	auto const bufferSize{sizeof(vertexIndexType) * indices.size()};
-	auto const [stagingBuffer, stagingBufferMemory] =
-	    makeBufferAndMemory(bufferSize,
-	                        vk::BufferUsageFlagBits::eTransferSrc,
-	                        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	// wrapped in double precision before narrowing, so the angle stays exact however long the scene has been turning
+	auto const angle = static_cast<float>(std::fmod(sceneState().rotation, 2.0 * std::numbers::pi));
 
-	auto const data = static_cast<std::add_pointer_t<vertexIndexType>>(stagingBufferMemory.mapMemory(0, bufferSize));
-	std::ranges::uninitialized_copy(indices, std::span{data, indices.size()});
-	stagingBufferMemory.unmapMemory();
+	// the scene turns under a fixed camera, which with a single instance is the model spinning in place
+	auto const sceneScale = static_cast<float>(instanceGridSide(options.instanceCount));
+	auto const rotation   = rotate(glm::mat4{1.0f}, angle, glm::vec3{0.0f, 0.0f, 1.0f});
+	auto const view       = lookAt(glm::vec3{2.0f * sceneScale}, {}, glm::vec3{0.0f, 0.0f, 1.0f}) * rotation;
+	auto const aspect     = static_cast<float>(swapchainExtent.width) / static_cast<float>(swapchainExtent.height);
+	auto       projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f * sceneScale, 10.0f * sceneScale);
+	projection[1][1] *= -1;
 
-	auto [retIndexBuffer, retIndexBufferMemory] = makeBufferAndMemory(bufferSize,
-	                                                                  vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-	                                                                  vk::MemoryPropertyFlagBits::eDeviceLocal);
-	copyBuffer(stagingBuffer, retIndexBuffer, bufferSize);
+	auto const viewProjection = ViewProjection{view, projection};
+	cameraUniformOffset       = uniformRing.push(viewProjection);
 
-	return {std::move(retIndexBuffer), std::move(retIndexBufferMemory)};
+	return viewProjection;
 }
 
-auto Application::makeUniformBuffers() const -> std::vector<BufferAndMemory>
+// written once here and read by every frame, so the CPU cost per frame does not depend on the instance count
+auto Application::makeInstanceBuffer() const -> BufferAndMemory
 {
-	constexpr auto bufferSize            = sizeof(ModelViewProjection);
-	auto           retBuffersAndMemories = std::vector<BufferAndMemory>{};
-	retBuffersAndMemories.reserve(MAX_FRAMES_IN_FLIGHT);
+	auto const bufferSize      = vk::DeviceSize{sizeof(InstanceData)} * options.instanceCount;
+	auto       bufferAndMemory = makeBufferAndMemory(bufferSize,
+	                                                 vk::BufferUsageFlagBits::eStorageBuffer,
+	                                                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	// the mesh's dequantisation applies first, taking its decoded positions back to model space
+	auto const [meshScale, meshOffset] = mesh.dequantisation();
+	auto const side                    = instanceGridSide(options.instanceCount);
+	auto const centre                  = static_cast<float>(side - 1u) * INSTANCE_SPACING / 2.0f;
+	auto const instances = std::span{static_cast<InstanceData*>(bufferAndMemory.allocation.mappedData()), options.instanceCount};
+
+	for (auto const i : rv::iota(0u, options.instanceCount)) {
+		auto const position = glm::vec3{static_cast<float>(i % side) * INSTANCE_SPACING - centre,
+		                                static_cast<float>(i / side) * INSTANCE_SPACING - centre,
+		                                0.0f};
+		instances[i]        = {glm::scale(glm::translate(glm::mat4{1.0f}, position + meshOffset), meshScale)};
+	}
+
+	return bufferAndMemory;
+}
+
+auto Application::makeReadbackBuffers() const -> std::vector<BufferAndMemory>
+{
+	auto retBuffersAndMemories = std::vector<BufferAndMemory>{};
+	if (not options.readbackDirectory.has_value()) {
+		return retBuffersAndMemories;
+	}
+
+	auto const bufferSize = vk::DeviceSize{swapchainExtent.width} * swapchainExtent.height * 4u;
+	retBuffersAndMemories.reserve(framesInFlight);
 
 	std::ranges::generate_n(std::back_inserter(retBuffersAndMemories),
-	                        MAX_FRAMES_IN_FLIGHT,
-	                        [this]
+	                        framesInFlight,
+	                        [&]
 	                        {
 		                        return makeBufferAndMemory(bufferSize,
-		                                                   vk::BufferUsageFlagBits::eUniformBuffer,
+		                                                   vk::BufferUsageFlagBits::eTransferDst,
 		                                                   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 	                        });
 
 	return retBuffersAndMemories;
 }
 
-auto Application::mapUniformBuffers() -> std::vector<void*>
+auto Application::mapReadbackBuffers() -> std::vector<void*>
 {
-	constexpr auto bufferSize = sizeof(ModelViewProjection);
-	auto           retMaps    = std::vector<void*>{};
-	retMaps.reserve(MAX_FRAMES_IN_FLIGHT);
+	auto retMaps = std::vector<void*>{};
+	retMaps.reserve(readbackBuffersAndMemories.size());
 
-	std::ranges::transform(uniformBuffersAndMemories,
+	std::ranges::transform(readbackBuffersAndMemories,
 	                       std::back_inserter(retMaps),
-	                       [](auto const& bufferAndMemory) { return bufferAndMemory.bufferMemory.mapMemory(0, bufferSize); });
+	                       [](auto const& bufferAndMemory) { return bufferAndMemory.allocation.mappedData(); });
 
 	return retMaps;
 }
 
-auto Application::updateUniformBuffer(std::uint32_t const currentImage) const -> void
+auto Application::writeReadback(std::uint32_t const frameIndex) -> void
 {
-	static auto startTime   = std::chrono::high_resolution_clock::now();
-	auto const  currentTime = std::chrono::high_resolution_clock::now();
-	auto const  deltaTime   = std::chrono::duration<float, std::chrono::seconds::period>{currentTime - startTime};
+	auto& pending = pendingReadbacks.at(frameIndex);
+	if (not pending.has_value()) {
+		return;
+	}
 
-	auto const  model = rotate(glm::mat4{1.0f}, deltaTime.count() * glm::radians(90.0f), glm::vec3{0.0f, 0.0f, 1.0f});
-	auto const  view  = lookAt(glm::vec3{2.0f}, {}, glm::vec3{0.0f, 0.0f, 1.0f});
-	auto        projection =
-	    glm::perspective(glm::radians(45.0f), static_cast<float>(swapchainExtent.width) / static_cast<float>(swapchainExtent.height), 0.1f, 10.0f);
-	projection[1][1] *= -1;
+	auto const filePath = *options.readbackDirectory / fmt::format("frame_{:05}.png", *pending);
+	auto const width    = static_cast<int>(swapchainExtent.width);
+	auto const height   = static_cast<int>(swapchainExtent.height);
+
+	if (stbi_write_png(filePath.string().c_str(), width, height, STBI_rgb_alpha, readbackBuffersMaps.at(frameIndex), width * STBI_rgb_alpha) == 0) {
+		throw std::runtime_error{std::format("failed to write frame: {}", filePath.string())};
+	}
 
-	auto const mvproj = ModelViewProjection{model, view, projection};
-	std::ranges::copy(std::span{&mvproj, 1}, static_cast<ModelViewProjection*>(uniformBuffersMaps[currentImage]));
+	pending.reset();
 }
 
 auto Application::makeDescriptorPool() const -> vkr::DescriptorPool
 {
-	auto const uniformPoolSize = vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT};
-	auto const samplerPoolSize = vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT};
-	auto const poolSizes       = std::array{uniformPoolSize, samplerPoolSize};
-	auto const poolInfo        = vk::DescriptorPoolCreateInfo{vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, MAX_FRAMES_IN_FLIGHT, poolSizes};
+	constexpr auto uniformPoolSize = vk::DescriptorPoolSize{vk::DescriptorType::eUniformBufferDynamic, 1u};
+	constexpr auto samplerPoolSize = vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 1u};
+	constexpr auto storagePoolSize = vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 1u};
+	constexpr auto poolSizes       = std::array{uniformPoolSize, samplerPoolSize, storagePoolSize};
+	auto const     poolInfo        = vk::DescriptorPoolCreateInfo{vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, 1u, poolSizes};
 
 	return logicalDevice.createDescriptorPool(poolInfo);
 }
 
-auto Application::makeDescriptorSets() -> vkr::DescriptorSets
+auto Application::makeDescriptorSet() const -> vkr::DescriptorSet
 {
-	auto const layouts           = std::vector{MAX_FRAMES_IN_FLIGHT, *descriptorSetLayout};
-	auto const allocInfo         = vk::DescriptorSetAllocateInfo{*descriptorPool, layouts};
-	auto       retDescriptorSets = vkr::DescriptorSets{logicalDevice, allocInfo};
-
-	for (auto const i : rv::iota(0u, MAX_FRAMES_IN_FLIGHT)) {
-		auto const bufferInfo            = vk::DescriptorBufferInfo{*uniformBuffersAndMemories.at(i).buffer, {}, sizeof(ModelViewProjection)};
-		auto const imageInfo             = vk::DescriptorImageInfo{*textureSampler, *textureImageView, vk::ImageLayout::eReadOnlyOptimal};
-		auto const bufferDescriptorWrite = vk::WriteDescriptorSet{*retDescriptorSets.at(i), 0, 0, vk::DescriptorType::eUniformBuffer, {}, bufferInfo};
-		auto const imageDescriptorWrite =
-		    vk::WriteDescriptorSet{*retDescriptorSets.at(i), 1, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo};
-
-		logicalDevice.updateDescriptorSets({bufferDescriptorWrite, imageDescriptorWrite}, {});
-	}
-
-	return retDescriptorSets;
+	auto const allocInfo        = vk::DescriptorSetAllocateInfo{*descriptorPool, *descriptorSetLayout};
+	auto       retDescriptorSet = std::move(vkr::DescriptorSets{logicalDevice, allocInfo}.front());
+
+	// the range is one camera block; each frame's dynamic offset says where in the ring that block is
+	auto const bufferInfo   = vk::DescriptorBufferInfo{uniformRing.buffer(), {}, sizeof(ViewProjection)};
+	auto const imageInfo    = vk::DescriptorImageInfo{*textureSampler, *textureImageView, vk::ImageLayout::eReadOnlyOptimal};
+	auto const instanceInfo = vk::DescriptorBufferInfo{*instanceBufferAndMemory.buffer, {}, VK_WHOLE_SIZE};
+	auto const bufferDescriptorWrite =
+	    vk::WriteDescriptorSet{*retDescriptorSet, 0, 0, vk::DescriptorType::eUniformBufferDynamic, {}, bufferInfo};
+	auto const imageDescriptorWrite = vk::WriteDescriptorSet{*retDescriptorSet, 1, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo};
+	auto const instanceDescriptorWrite =
+	    vk::WriteDescriptorSet{*retDescriptorSet, 2, 0, vk::DescriptorType::eStorageBuffer, {}, instanceInfo};
+
+	logicalDevice.updateDescriptorSets({bufferDescriptorWrite, imageDescriptorWrite, instanceDescriptorWrite}, {});
+
+	return retDescriptorSet;
 }
 
 auto Application::makeImageAndMemory(std::uint32_t const            width,
                                      std::uint32_t const            height,
+                                     std::uint32_t const            mipLevels,
                                      vk::Format const&              format,
                                      vk::ImageTiling const&         tiling,
                                      vk::ImageUsageFlags const&     usage,
@@ -854,7 +1528,7 @@ auto Application::makeImageAndMemory(std::uint32_t const            width,
 	                                           vk::ImageType::e2D,
 	                                           format,
 	                                           vk::Extent3D{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), 1u},
-	                                           1u,
+	                                           mipLevels,
 	                                           1u,
 	                                           vk::SampleCountFlagBits::e1,
 	                                           tiling,
@@ -863,142 +1537,135 @@ auto Application::makeImageAndMemory(std::uint32_t const            width,
 	                                           {},
 	                                           vk::ImageLayout::eUndefined};
 
-	auto       image           = logicalDevice.createImage(imageInfo);
-	auto const memRequirements = image.getMemoryRequirements();
-	auto const allocInfo       = vk::MemoryAllocateInfo{memRequirements.size, findMemoryType(memRequirements.memoryTypeBits, properties)};
-	auto       imageMemory     = logicalDevice.allocateMemory(allocInfo);
-	image.bindMemory(*imageMemory, 0u);
+	auto image      = logicalDevice.createImage(imageInfo);
+	auto allocation = allocator.allocateFor(image, tiling, properties);
 
-	return {std::move(image), std::move(imageMemory)};
+	return {std::move(image), std::move(allocation)};
 }
 
-auto Application::makeTextureImage(fs::path const& texturePath) const -> ImageAndMemory
+auto Application::selectTextureFormat(fs::path const& texturePath) const -> vk::Format
 {
-	int        texWidth, texHeight, texChannels;
-	auto const pixels    = stbi_load(texturePath.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-	auto const imageSize = static_cast<vk::DeviceSize>(texWidth) * texHeight * STBI_rgb_alpha;
-	auto const pixelSpan = std::span{pixels, imageSize};
-
-	if (pixels == nullptr) {
-		throw std::runtime_error{std::format("Failed to load texture image: {}", texturePath.string())};
+	// encodings written by texture_encoder beside the source image, best quality first; the source itself is always usable
+	auto candidates = std::vector<vk::Format>{};
+	for (auto const format : COMPRESSED_TEXTURE_FORMATS) {
+		auto const path = compressedTexturePath(texturePath, format);
+		if (auto error = std::error_code{}; fs::is_regular_file(path, error) and isUsableEncoding(path, format)) {
+			candidates.push_back(format);
+		}
 	}
+	candidates.push_back(UNCOMPRESSED_TEXTURE_FORMAT);
 
-	auto [stagingBuffer, stagingBufferMemory] =
-	    makeBufferAndMemory(imageSize,
-	                        vk::BufferUsageFlagBits::eTransferSrc,
-	                        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-	auto const data = static_cast<stbi_uc*>(stagingBufferMemory.mapMemory(0, imageSize));
-	std::ranges::uninitialized_copy(pixelSpan, std::span{data, imageSize});
-
-	stagingBufferMemory.unmapMemory();
-	stbi_image_free(pixels);
-
-	auto [textureImage, textureImageMemory] = makeImageAndMemory(texWidth,
-	                                                             texHeight,
-	                                                             vk::Format::eR8G8B8A8Srgb,
-	                                                             vk::ImageTiling::eOptimal,
-	                                                             vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-	                                                             vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-	transitionImageLayout(textureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-	copyBufferToImage(stagingBuffer, textureImage, static_cast<std::uint32_t>(texWidth), static_cast<std::uint32_t>(texHeight));
-	transitionImageLayout(textureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-
-	return {std::move(textureImage), std::move(textureImageMemory)};
+	return findSupportedFormat(candidates,
+	                           vk::ImageTiling::eOptimal,
+	                           vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+	                               vk::FormatFeatureFlagBits::eTransferDst);
 }
 
-auto Application::beginSingleTimeCommands() const -> vkr::CommandBuffer
+auto Application::makeTextureImage(UploadBatch& uploads, fs::path const& texturePath) const -> ImageAndMemory
 {
-	auto const     allocInfo     = vk::CommandBufferAllocateInfo{*commandPool, vk::CommandBufferLevel::ePrimary, 1u};
-	auto           commandBuffer = std::move(logicalDevice.allocateCommandBuffers(allocInfo).front());
-	constexpr auto beginInfo     = vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
+	if (textureFormat != UNCOMPRESSED_TEXTURE_FORMAT) {
+		return makeCompressedTextureImage(uploads, compressedTexturePath(texturePath, textureFormat));
+	}
 
-	commandBuffer.begin(beginInfo);
+	constexpr auto format = UNCOMPRESSED_TEXTURE_FORMAT;
 
-	return commandBuffer;
-}
+	// stb returns the file's own channel count, and the widening to RGBA writes straight into staging memory
+	int        texWidth, texHeight, texChannels;
+	auto const pixels = stbi_load(texturePath.string().c_str(), &texWidth, &texHeight, &texChannels, 0);
 
-auto Application::endSingleTimeCommands(vkr::CommandBuffer&& commandBuffer) const -> void
-{
-	commandBuffer.end();
-	auto const submitInfo = vk::SubmitInfo{{}, {}, *commandBuffer, {}};
-	graphicsQueue.submit(submitInfo, {});
-	graphicsQueue.waitIdle();
-}
+	if (pixels == nullptr) {
+		throw std::runtime_error{std::format("Failed to load texture image: {}", texturePath.string())};
+	}
 
-auto Application::transitionImageLayout(vkr::Image const&      image,
-                                        vk::Format const&      format,
-                                        vk::ImageLayout const& oldLayout,
-                                        vk::ImageLayout const& newLayout) const -> void
-{
-	constexpr static auto getMasksAndStages =
-	    [](vk::ImageLayout const& oldLayout,
-	       vk::ImageLayout const& newLayout) -> std::tuple<vk::AccessFlags, vk::AccessFlags, vk::PipelineStageFlags, vk::PipelineStageFlags>
-	{
-		if (oldLayout == vk::ImageLayout::eUndefined and newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) {
-			return {vk::AccessFlagBits::eNone,
-			        vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
-			        vk::PipelineStageFlagBits::eTopOfPipe,
-			        vk::PipelineStageFlagBits::eEarlyFragmentTests};
-		}
-		if (oldLayout == vk::ImageLayout::eUndefined and newLayout == vk::ImageLayout::eTransferDstOptimal) {
-			return {vk::AccessFlagBits::eNone,
-			        vk::AccessFlagBits::eTransferWrite,
-			        vk::PipelineStageFlagBits::eTopOfPipe,
-			        vk::PipelineStageFlagBits::eTransfer};
-		}
-		if (oldLayout == vk::ImageLayout::eTransferDstOptimal and newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-			return {vk::AccessFlagBits::eTransferWrite,
-			        vk::AccessFlagBits::eShaderRead,
-			        vk::PipelineStageFlagBits::eTransfer,
-			        vk::PipelineStageFlagBits::eFragmentShader};
-		}
-		throw std::invalid_argument{"Unsupported layout transition"};
-	};
+	auto const width     = static_cast<std::uint32_t>(texWidth);
+	auto const height    = static_cast<std::uint32_t>(texHeight);
+	auto const channels  = static_cast<std::uint32_t>(texChannels);
+	auto const pixelSpan = std::span{pixels, std::size_t{width} * height * channels};
+	auto const mipLevels = mipLevelCount(width, height);
+	auto const blit      = canBlitMipmaps(format);
+
+	// with blits only the base level is staged; otherwise the whole chain is filtered in place in the staging buffer
+	auto const levels  = blit ? std::vector{MipLevel{width, height, 0u}} : mipChainLevels(width, height);
+	auto const staging = uploads.reserveStaging(mipChainSize(levels), not blit);
+	expandToRgba(std::as_bytes(pixelSpan), channels, staging.bytes);
+	stbi_image_free(pixels);
+	if (not blit) {
+		downsampleSrgbMipChain(staging.bytes, levels);
+	}
 
-	static auto const getAspectMask = [&format](vk::ImageLayout const& newLayout) -> vk::ImageAspectFlags
-	{
-		if (newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) {
-			if (hasStencilComponent(format)) {
-				return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
-			}
-			return vk::ImageAspectFlagBits::eDepth;
+	auto [textureImage, textureAllocation] =
+	    makeImageAndMemory(width,
+	                       height,
+	                       mipLevels,
+	                       format,
+	                       vk::ImageTiling::eOptimal,
+	                       vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+	                       vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	uploads.transitionImageLayout(*textureImage, format, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
+	if (blit) {
+		uploads.copyBufferToImage(staging.buffer, *textureImage, width, height);
+		uploads.generateMipmaps(*textureImage, width, height, mipLevels);
+	} else {
+		for (auto level = std::uint32_t{0}; level < mipLevels; ++level) {
+			auto const& [levelWidth, levelHeight, offset] = levels.at(level);
+			uploads.copyBufferToImage(staging.buffer, *textureImage, levelWidth, levelHeight, level, offset);
 		}
-		return vk::ImageAspectFlagBits::eColor;
-	};
+		uploads.transitionImageLayout(
+		    *textureImage, format, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mipLevels);
+	}
 
-	auto const [srcAccessMask, dstAccessMask, srcStage, dstStage] = getMasksAndStages(oldLayout, newLayout);
+	return {std::move(textureImage), std::move(textureAllocation)};
+}
 
-	auto       commandBuffer = beginSingleTimeCommands();
-	auto const barrier       = vk::ImageMemoryBarrier{srcAccessMask,
-                                                dstAccessMask,
-                                                oldLayout,
-                                                newLayout,
-                                                VK_QUEUE_FAMILY_IGNORED,
-                                                VK_QUEUE_FAMILY_IGNORED,
-                                                *image,
-                                                vk::ImageSubresourceRange{getAspectMask(newLayout), 0u, 1u, 0u, 1u}};
+auto Application::makeCompressedTextureImage(UploadBatch& uploads, fs::path const& path) const -> ImageAndMemory
+{
+	// the levels are copied straight out of the mapped file, headers and all, so staging is a single memcpy
+	auto const texture = Ktx2Texture{path};
+	// selectTextureFormat read this file already, so only one replaced since then can fail here; the image and its view must agree
+	if (texture.format() != textureFormat) {
+		throw std::runtime_error{fmt::format("{} holds {} texels, not the {} its name promises; re-run texture_encoder",
+		                                     path.string(),
+		                                     vk::to_string(texture.format()),
+		                                     vk::to_string(textureFormat))};
+	}
 
-	commandBuffer.pipelineBarrier(srcStage, dstStage, {}, {}, {}, barrier);
+	auto const mipLevels     = static_cast<std::uint32_t>(texture.levels().size());
+	auto const stagingBuffer = uploads.stage(texture.bytes());
+
+	auto [textureImage, textureAllocation] = makeImageAndMemory(texture.width(),
+	                                                            texture.height(),
+	                                                            mipLevels,
+	                                                            texture.format(),
+	                                                            vk::ImageTiling::eOptimal,
+	                                                            vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+	                                                            vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	uploads.transitionImageLayout(*textureImage, texture.format(), vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
+	for (auto level = std::uint32_t{0}; level < mipLevels; ++level) {
+		auto const& [levelWidth, levelHeight, offset] = texture.levels()[level];
+		uploads.copyBufferToImage(stagingBuffer, *textureImage, levelWidth, levelHeight, level, offset);
+	}
+	uploads.transitionImageLayout(
+	    *textureImage, texture.format(), vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mipLevels);
 
-	endSingleTimeCommands(std::move(commandBuffer));
+	return {std::move(textureImage), std::move(textureAllocation)};
 }
 
-auto Application::copyBufferToImage(vkr::Buffer const& buffer, vkr::Image const& image, std::uint32_t width, std::uint32_t height) const -> void
+auto Application::canBlitMipmaps(vk::Format const& format) const -> bool
 {
-	auto       commandBuffer = beginSingleTimeCommands();
-	auto const region =
-	    vk::BufferImageCopy{0u, 0u, 0u, vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u}, {0, 0, 0}, {width, height, 1u}};
+	// blits are graphics commands, and texture uploads run on the transfer queue
+	auto const queueFlags = physicalDevice.getQueueFamilyProperties().at(*queueFamilyIndices.transferFamily).queueFlags;
+	auto const features   = physicalDevice.getFormatProperties(format).optimalTilingFeatures;
+	auto const required =
+	    vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
 
-	commandBuffer.copyBufferToImage(*buffer, *image, vk::ImageLayout::eTransferDstOptimal, region);
-
-	endSingleTimeCommands(std::move(commandBuffer));
+	return (queueFlags & vk::QueueFlagBits::eGraphics) and (features & required) == required;
 }
 
 auto Application::makeTextureImageView() const -> vkr::ImageView
 {
-	return makeImageView(*textureImageAndMemory.image, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor);
+	return makeImageView(*textureImageAndMemory.image, textureFormat, vk::ImageAspectFlagBits::eColor, VK_REMAINING_MIP_LEVELS);
 }
 
 auto Application::makeTextureSampler() const -> vkr::Sampler
@@ -1017,7 +1684,7 @@ auto Application::makeTextureSampler() const -> vkr::Sampler
 	                                               VK_FALSE,
 	                                               vk::CompareOp::eAlways,
 	                                               0.0f,
-	                                               0.0f,
+	                                               VK_LOD_CLAMP_NONE,
 	                                               vk::BorderColor::eIntOpaqueBlack,
 	                                               VK_FALSE};
 
@@ -1026,22 +1693,23 @@ auto Application::makeTextureSampler() const -> vkr::Sampler
 
 auto Application::makeDepthImage() const -> ImageAndMemory
 {
-	auto const depthFormat              = findDepthFormat();
-	auto [depthImage, depthImageMemory] = makeImageAndMemory(swapchainExtent.width,
-	                                                         swapchainExtent.height,
-	                                                         depthFormat,
-	                                                         vk::ImageTiling::eOptimal,
-	                                                         vk::ImageUsageFlagBits::eDepthStencilAttachment,
-	                                                         vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-	transitionImageLayout(depthImage, depthFormat, vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-	return {std::move(depthImage), std::move(depthImageMemory)};
+	auto const depthFormat             = findDepthFormat();
+	auto [depthImage, depthAllocation] = makeImageAndMemory(swapchainExtent.width,
+	                                                        swapchainExtent.height,
+	                                                        1u,
+	                                                        depthFormat,
+	                                                        vk::ImageTiling::eOptimal,
+	                                                        vk::ImageUsageFlagBits::eDepthStencilAttachment,
+	                                                        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	// no layout transition: the render pass takes the depth attachment from eUndefined each frame, so a replacement made on resize
+	// needs no commands either
+	return {std::move(depthImage), std::move(depthAllocation)};
 }
 
 auto Application::makeDepthImageView() const -> vkr::ImageView
 {
-	return makeImageView(*depthImageAndMemory.image, findDepthFormat(), vk::ImageAspectFlagBits::eDepth);
+	return makeImageView(*depthImageAndMemory.image, findDepthFormat(), vk::ImageAspectFlagBits::eDepth, 1u);
 }
 
 auto Application::findSupportedFormat(std::span<vk::Format const>   candidates,
@@ -1075,51 +1743,48 @@ auto Application::findDepthFormat() const -> vk::Format
 	                           vk::FormatFeatureFlagBits::eDepthStencilAttachment);
 }
 
-auto Application::loadModel(fs::path const& modelPath) -> VerticesAndIndices<std::uint32_t>
+auto Application::loadModel(fs::path const& modelPath) const -> Mesh
 {
-	auto attributes  = tinyobj::attrib_t{};
-	auto shapes      = std::vector<tinyobj::shape_t>{};
-	auto materials   = std::vector<tinyobj::material_t>{};
-	auto warn        = std::string{};
-	auto err         = std::string{};
-	auto modelStream = std::ifstream{modelPath};
-
-	if (!tinyobj::LoadObj(&attributes, &shapes, &materials, &warn, &err, &modelStream)) {
-		throw std::runtime_error{warn + err};
+	auto const cache = MeshCache{MESH_CACHE_DIRECTORY, static_cast<std::uint64_t>(options.meshOptimisation)};
+	if (auto cached = cache.find(modelPath); cached.has_value()) {
+		return std::move(*cached);
 	}
 
-	auto vertices       = std::vector<Vertex>{};
-	auto indices        = std::vector<std::uint32_t>{};
-	auto uniqueVertices = std::unordered_map<Vertex, uint32_t, decltype(vertexHash)>{0, vertexHash};
-
-	for (auto const& shape : shapes) {
-		for (auto const& [vertex_index, normal_index, texcoord_index] : shape.mesh.indices) {
-			Vertex vertex{};
-
-			vertex.position = {attributes.vertices[3 * vertex_index + 0],
-			                   attributes.vertices[3 * vertex_index + 1],
-			                   attributes.vertices[3 * vertex_index + 2]};
-
-			vertex.texCoord = {attributes.texcoords[2 * texcoord_index + 0], 1.0f - attributes.texcoords[2 * texcoord_index + 1]};
+	auto arrays = parseModel(modelPath);
+	if (options.meshOptimisation != MeshOptimisation::none) {
+		optimiseMesh(arrays, options.meshOptimisation);
+	}
+	auto mesh = Mesh{std::move(arrays)};
 
-			vertex.colour = glm::vec3{1.0f};
+	// a cache that cannot be written only costs the next start its parse
+	try {
+		cache.store(modelPath, mesh);
+	} catch (std::exception const& e) {
+		fmt::print(stderr, "warning: {}\n", e.what());
+	}
 
-			if (!uniqueVertices.contains(vertex)) {
-				uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-				vertices.emplace_back(vertex);
-			}
+	return mesh;
+}
 
-			indices.emplace_back(uniqueVertices[vertex]);
-		}
+auto Application::parseModel(fs::path const& modelPath) const -> VerticesAndIndices<std::uint32_t>
+{
+	auto const threadCount = options.loadThreads != 0u ? options.loadThreads : std::max(std::thread::hardware_concurrency(), 1u);
+	if (auto parsed = loadObjParallel(modelPath, threadCount); parsed.has_value()) {
+		return std::move(*parsed);
 	}
 
-	return {vertices, indices};
+	return loadObj(modelPath);
 }
 
 Application::QueueFamilyIndices::QueueFamilyIndices(vkr::PhysicalDevice const& physDev, vkr::SurfaceKHR const& surface)
     : graphicsFamily{findGraphicsQueueFamilyIndex(physDev)},
-      presentFamily{findPresentQueueFamilyIndex(physDev, surface)}
-{}
+      presentFamily{*surface ? findPresentQueueFamilyIndex(physDev, surface) : graphicsFamily},
+      transferFamily{findTransferQueueFamilyIndex(physDev)}
+{
+	if (not transferFamily.has_value()) {
+		transferFamily = graphicsFamily;
+	}
+}
 
 auto Application::QueueFamilyIndices::findGraphicsQueueFamilyIndex(vkr::PhysicalDevice const& physDev) -> std::optional<std::uint32_t>
 {
@@ -1150,11 +1815,29 @@ auto Application::QueueFamilyIndices::findPresentQueueFamilyIndex(vkr::PhysicalD
 	return {};
 }
 
+auto Application::QueueFamilyIndices::findTransferQueueFamilyIndex(vkr::PhysicalDevice const& physDev) -> std::optional<std::uint32_t>
+{
+	auto const queueFamilyProps = physDev.getQueueFamilyProperties();
+	auto const hasFlags         = [](vk::QueueFamilyProperties const& queueFamily, vk::QueueFlags const& flags)
+	{ return queueFamily.queueCount > 0 and (queueFamily.queueFlags & flags) == flags; };
+
+	// a family without graphics or compute is usually backed by dedicated copy engines; fall back to any non-graphics family
+	for (auto const excluded : {vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute, vk::QueueFlags{vk::QueueFlagBits::eGraphics}}) {
+		for (auto i{0u}; i < queueFamilyProps.size(); ++i) {
+			if (hasFlags(queueFamilyProps[i], vk::QueueFlagBits::eTransfer) and not(queueFamilyProps[i].queueFlags & excluded)) {
+				return i;
+			}
+		}
+	}
+
+	return {};
+}
+
 auto Application::QueueFamilyIndices::isComplete() const -> bool { return graphicsFamily.has_value() and presentFamily.has_value(); }
 
 auto Application::QueueFamilyIndices::indices() const -> std::vector<std::uint32_t>
 {
-	static auto indices{std::vector<std::uint32_t>{}};
+	auto indices = std::vector<std::uint32_t>{};
 	indices.reserve(2);
 
 	if (graphicsFamily.has_value()) {
@@ -1168,9 +1851,9 @@ auto Application::QueueFamilyIndices::indices() const -> std::vector<std::uint32
 }
 
 Application::SwapchainSupportDetails::SwapchainSupportDetails(vkr::PhysicalDevice const& physDev, vkr::SurfaceKHR const& surface)
-    : capabilities{physDev.getSurfaceCapabilitiesKHR(*surface)},
-      formats{physDev.getSurfaceFormatsKHR(*surface)},
-      presentModes{physDev.getSurfacePresentModesKHR(*surface)}
+    : capabilities{*surface ? physDev.getSurfaceCapabilitiesKHR(*surface) : vk::SurfaceCapabilitiesKHR{}},
+      formats{*surface ? physDev.getSurfaceFormatsKHR(*surface) : std::vector<vk::SurfaceFormatKHR>{}},
+      presentModes{*surface ? physDev.getSurfacePresentModesKHR(*surface) : std::vector<vk::PresentModeKHR>{}}
 {}
 
 auto Application::SwapchainSupportDetails::isAdequate() const -> bool { return not(formats.empty() or presentModes.empty()); }
@@ -1,11 +1,26 @@
 #pragma once
 
+#include "AsyncUploader.hpp"
+#include "DeviceAllocator.hpp"
+#include "FramePacer.hpp"
+#include "FrameStats.hpp"
+#include "FrustumCuller.hpp"
+#include "Mesh.hpp"
+#include "Options.hpp"
+#include "ParallelRecorder.hpp"
+#include "PipelineCache.hpp"
+#include "Simulation.hpp"
+#include "UniformRing.hpp"
+#include "UploadBatch.hpp"
+
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <glm/matrix.hpp>
-#include <glm/vec2.hpp>
-#include <glm/vec3.hpp>
+#include <memory>
 #include <optional>
 #include <ranges>
 #include <string>
@@ -30,68 +45,48 @@ struct PipelineLayoutAndPipeline
 	vkr::Pipeline       pipeline;
 };
 
-struct BufferAndMemory
-{
-	vkr::Buffer       buffer;
-	vkr::DeviceMemory bufferMemory;
-};
-
-struct ImageAndMemory
+struct FrameQueryPools
 {
-	vkr::Image        image;
-	vkr::DeviceMemory imageMemory;
+	vkr::QueryPool timestamps;
+	vkr::QueryPool statistics;
+	bool           pending{};
 };
 
-struct Vertex
+// everything sized to a swapchain's images, kept after a resize until the frames that drew into them have finished
+struct RetiredSwapchain
 {
-	glm::vec3 position{};
-	glm::vec3 colour{};
-	glm::vec2 texCoord{};
-
-	// descriptions
-	static consteval auto getBindingDescription() -> vk::VertexInputBindingDescription { return {0, sizeof(Vertex)}; }
-
-	static consteval auto getAttributeDescriptions() -> std::array<vk::VertexInputAttributeDescription, 3>
-	{
-		constexpr auto positionAttribute =
-		    vk::VertexInputAttributeDescription{{}, {}, vk::Format::eR32G32B32Sfloat, static_cast<unsigned>(offsetof(Vertex, position))};
-		constexpr auto colourAttribute =
-		    vk::VertexInputAttributeDescription{1, {}, vk::Format::eR32G32B32Sfloat, static_cast<unsigned>(offsetof(Vertex, colour))};
-		constexpr auto texCoordAttribute =
-		    vk::VertexInputAttributeDescription{2u, 0u, vk::Format::eR32G32Sfloat, static_cast<unsigned>(offsetof(Vertex, texCoord))};
-
-		return {positionAttribute, colourAttribute, texCoordAttribute};
-	}
-
-	constexpr auto operator==(Vertex const& other) const -> bool
-	{
-		return position == other.position && colour == other.colour && texCoord == other.texCoord;
-	}
+	vkr::SwapchainKHR             swapchain;
+	std::vector<vkr::ImageView>   imageViews;
+	std::vector<vkr::Framebuffer> framebuffers;
+	ImageAndMemory                depthImageAndMemory;
+	vkr::ImageView                depthImageView;
 };
 
-template<typename IndexType>
-    requires std::unsigned_integral<IndexType>
-struct VerticesAndIndices
+// shared by every instance, so it is all that changes per frame
+struct ViewProjection
 {
-	std::vector<Vertex>    vertices;
-	std::vector<IndexType> vertexIndices;
+	glm::mat4 view{};
+	glm::mat4 projection{};
 };
 
-struct ModelViewProjection
+// one std430 array element of the instance storage buffer
+struct InstanceData
 {
 	glm::mat4 model{};
-	glm::mat4 view{};
-	glm::mat4 projection{};
 };
 
 inline auto           validationLayers         = std::array{"VK_LAYER_KHRONOS_validation"};
 inline auto           requiredDeviceExtensions = std::array{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
-inline constexpr auto INIT_WIDTH  = 800u;
-inline constexpr auto INIT_HEIGHT = 800u;
+inline constexpr auto OFFSCREEN_FORMAT   = vk::Format::eR8G8B8A8Srgb;
+inline constexpr auto BENCH_FRAME_PERIOD = 1.0f / 60.0f;
+// room for every frame's uniform blocks, at minUniformBufferOffsetAlignment (at most 256 bytes) apiece
+inline constexpr auto UNIFORM_RING_FRAME_BYTES = vk::DeviceSize{64u * 1024u};
 
-auto const            MODEL_PATH   = std::filesystem::path{"../../src/models/viking_room.obj"};
-auto const            TEXTURE_PATH = std::filesystem::path{"../../src/textures/viking_room.png"};
+auto const            MODEL_PATH           = std::filesystem::path{"../../src/models/viking_room.obj"};
+auto const            TEXTURE_PATH         = std::filesystem::path{"../../src/textures/viking_room.png"};
+auto const            MESH_CACHE_DIRECTORY = std::filesystem::path{"mesh_cache"};
+auto const            PIPELINE_CACHE_PATH  = std::filesystem::path{"pipeline_cache.bin"};
 
 auto makeWindowPointer(Application& app, std::uint32_t width = 800, std::uint32_t height = 600, std::string_view windowName = "empty")
     -> GLFWWindowPointer;
@@ -100,12 +95,16 @@ class Application final
 {
 public:
 	//	CONSTRUCTORS, DESTRUCTORS
-	Application();
+	explicit Application(Options = {});
 	~Application();
 
 	//	INSTANCE PUBLIC
-	bool framebufferResized{};
-	auto run() -> void;
+	bool               framebufferResized{};
+	bool               redrawRequested{true};
+	auto               run() -> void;
+	auto               toggleAnimation() -> void;
+	[[nodiscard]] auto statistics() const -> FrameStats const&;
+	[[nodiscard]] auto memoryStatistics() const -> DeviceAllocatorStatistics;
 
 	//	STATIC PUBLIC
 
@@ -114,6 +113,8 @@ public:
 	{
 		std::optional<std::uint32_t> graphicsFamily{};
 		std::optional<std::uint32_t> presentFamily{};
+		// a transfer-only family when the device has one, otherwise the graphics family
+		std::optional<std::uint32_t> transferFamily{};
 
 		QueueFamilyIndices(vkr::PhysicalDevice const& physDev, vkr::SurfaceKHR const& surface);
 		[[nodiscard]] auto isComplete() const -> bool;
@@ -122,6 +123,7 @@ public:
 	private:
 		static auto findGraphicsQueueFamilyIndex(vkr::PhysicalDevice const& physDev) -> std::optional<uint32_t>;
 		static auto findPresentQueueFamilyIndex(vkr::PhysicalDevice const& physDev, vkr::SurfaceKHR const& surface) -> std::optional<uint32_t>;
+		static auto findTransferQueueFamilyIndex(vkr::PhysicalDevice const& physDev) -> std::optional<uint32_t>;
 	};
 
 	struct SwapchainSupportDetails
@@ -144,7 +146,8 @@ private:
 	bool const enableValidationLayers{true};
 #endif
 
-	std::uint32_t MAX_FRAMES_IN_FLIGHT{2u};
+	Options const options;
+	std::uint32_t framesInFlight{options.framesInFlight};
 	std::string   windowName{"Hello Triangle"};
 	std::string   applicationName{"Hello Triangle"};
 	std::uint32_t applicationVersion{VK_MAKE_API_VERSION(0, 1, 0, 0)};
@@ -152,7 +155,7 @@ private:
 	std::uint32_t engineVersion{VK_MAKE_API_VERSION(0, 1, 0, 0)};
 
 	// window
-	GLFWWindowPointer window{makeWindowPointer(*this, INIT_WIDTH, INIT_HEIGHT, windowName)};
+	GLFWWindowPointer window{options.headless ? nullptr : makeWindowPointer(*this, options.width, options.height, windowName)};
 
 	// context, instance, surface
 	vkr::Context  context{};
@@ -164,109 +167,182 @@ private:
 	vkr::SurfaceKHR surface{makeSurface()};
 
 	// device details
-	vkr::PhysicalDevice      physicalDevice{pickPhysicalDevice()};
-	QueueFamilyIndices const queueFamilyIndices{physicalDevice, surface};
-	SwapchainSupportDetails  swapchainSupport{physicalDevice, surface};
-	vkr::Device              logicalDevice{makeDevice()};
+	vkr::PhysicalDevice              physicalDevice{pickPhysicalDevice()};
+	vk::PhysicalDeviceFeatures const supportedFeatures{physicalDevice.getFeatures()};
+	QueueFamilyIndices const         queueFamilyIndices{physicalDevice, surface};
+	SwapchainSupportDetails          swapchainSupport{physicalDevice, surface};
+	vkr::Device                      logicalDevice{makeDevice()};
 
 	// queues
 	vkr::Queue graphicsQueue{logicalDevice.getQueue(queueFamilyIndices.graphicsFamily.value(), 0)};
 	vkr::Queue presentQueue{logicalDevice.getQueue(queueFamilyIndices.presentFamily.value(), 0)};
+	vkr::Queue transferQueue{logicalDevice.getQueue(queueFamilyIndices.transferFamily.value(), 0)};
+
+	// device memory; allocation happens in const factory functions, hence mutable
+	mutable DeviceAllocator allocator{logicalDevice, physicalDevice};
+
+	// uploads streamed through the transfer queue
+	AsyncUploader uploader{logicalDevice,
+	                       allocator,
+	                       transferQueue,
+	                       queueFamilyIndices.transferFamily.value(),
+	                       queueFamilyIndices.graphicsFamily.value()};
 
 	// swapchain details
 	vkr::SwapchainKHR           swapchain{makeSwapchain()};
-	vk::Format                  swapchainImageFormat{chooseSwapSurfaceFormat(swapchainSupport.formats).format};
-	vk::Extent2D                swapchainExtent{chooseSwapExtent(window, swapchainSupport.capabilities)};
+	vk::Format                  swapchainImageFormat{chooseImageFormat()};
+	vk::Extent2D                swapchainExtent{chooseImageExtent()};
+	std::vector<ImageAndMemory> offscreenImages{makeOffscreenImages()};
 	std::vector<vkr::ImageView> swapchainImageViews{makeImageViews()};
 
-	// render pass, pipeline
+	// render pass, pipeline; the cache outlives every pipeline created through it and is saved when it is destroyed
+	PipelineCache             pipelineCache{logicalDevice, physicalDevice, PIPELINE_CACHE_PATH};
 	vkr::RenderPass           renderPass{makeRenderPass()};
 	vkr::DescriptorSetLayout  descriptorSetLayout{makeDescriptorSetLayout()};
 	PipelineLayoutAndPipeline layoutAndPipeline{makeGraphicsPipeline()};
 
-	// command pool
-	vkr::CommandPool commandPool{makeCommandPool()};
+	// command pool; the streamed model is recorded into one batch, submitted at the end of the constructor
+	vkr::CommandPool             commandPool{makeCommandPool()};
+	std::unique_ptr<UploadBatch> assetUploads{uploader.makeBatch()};
 
 	// buffers, bound memories, images
-	VerticesAndIndices<std::uint32_t> verticesAndIndices{loadModel(MODEL_PATH)};
-	BufferAndMemory                   vertexBufferAndMemory{makeVertexBuffer()};
-	BufferAndMemory                   indexBufferAndMemory{makeIndexBuffer()};
-	ImageAndMemory                    textureImageAndMemory{makeTextureImage(TEXTURE_PATH)};
-	ImageAndMemory                    depthImageAndMemory{makeDepthImage()};
-	vkr::ImageView                    textureImageView{makeTextureImageView()};
-	vkr::ImageView                    depthImageView{makeDepthImageView()};
-	vkr::Sampler                      textureSampler{makeTextureSampler()};
-	std::vector<BufferAndMemory>      uniformBuffersAndMemories{makeUniformBuffers()};
-	std::vector<void*>                uniformBuffersMaps{mapUniformBuffers()};
+	Mesh                         mesh{loadModel(MODEL_PATH)};
+	BufferAndMemory              vertexBufferAndMemory{makeVertexBuffer(*assetUploads)};
+	BufferAndMemory              indexBufferAndMemory{makeIndexBuffer(*assetUploads)};
+	vk::Format                   textureFormat{selectTextureFormat(TEXTURE_PATH)};
+	ImageAndMemory               textureImageAndMemory{makeTextureImage(*assetUploads, TEXTURE_PATH)};
+	ImageAndMemory               depthImageAndMemory{makeDepthImage()};
+	vkr::ImageView               textureImageView{makeTextureImageView()};
+	vkr::ImageView               depthImageView{makeDepthImageView()};
+	vkr::Sampler                 textureSampler{makeTextureSampler()};
+	UniformRing                  uniformRing{
+        logicalDevice, allocator, physicalDevice.getProperties().limits, framesInFlight, UNIFORM_RING_FRAME_BYTES};
+	BufferAndMemory              instanceBufferAndMemory{makeInstanceBuffer()};
 
 	// framebuffer
 	std::vector<vkr::Framebuffer> swapchainFramebuffers{makeFramebuffers()};
 
-	// descriptor pool
-	vkr::DescriptorPool             descriptorPool{makeDescriptorPool()};
-	std::vector<vkr::DescriptorSet> descriptorSets{makeDescriptorSets()};
+	// headless readback
+	std::vector<BufferAndMemory>              readbackBuffersAndMemories{makeReadbackBuffers()};
+	std::vector<void*>                        readbackBuffersMaps{mapReadbackBuffers()};
+	std::vector<std::optional<std::uint64_t>> pendingReadbacks{std::vector<std::optional<std::uint64_t>>(framesInFlight)};
+
+	// descriptor pool; one set serves every frame, which picks out its own uniform data with a dynamic offset
+	vkr::DescriptorPool descriptorPool{makeDescriptorPool()};
+	vkr::DescriptorSet  descriptorSet{makeDescriptorSet()};
+
+	// command buffers; with --record-threads the draws go into per-thread secondaries that each frame's primary executes
+	std::vector<vkr::CommandBuffer>   commandBuffers{makeCommandBuffers()};
+	std::unique_ptr<ParallelRecorder> parallelRecorder{makeParallelRecorder()};
 
-	// command buffers
-	std::vector<vkr::CommandBuffer> commandBuffers{makeCommandBuffers()};
+	// with --gpu-culling, a compute pass picks the instances to draw and the render pass draws them indirectly
+	std::unique_ptr<FrustumCuller> frustumCuller{makeFrustumCuller()};
+
+	// GPU timestamp and pipeline statistics queries
+	std::uint32_t const          timestampValidBits{findTimestampValidBits()};
+	float const                  timestampPeriod{physicalDevice.getProperties().limits.timestampPeriod};
+	std::vector<FrameQueryPools> queryPools{makeQueryPools()};
 
 	// synchronisation
 	std::vector<vkr::Semaphore> imageAvailableSemaphores{makeSemaphores()};
 	std::vector<vkr::Semaphore> renderFinishedSemaphores{makeSemaphores()};
-	std::vector<vkr::Fence>     inFlightFences{makeFences()};
-	std::uint32_t               currentFrameIndex{0u};
+	FramePacer                  framePacer{logicalDevice, framesInFlight, options.lowLatency};
+	std::uint32_t               cameraUniformOffset{0u};
+	std::uint64_t               frameNumber{0u};
+
+	// swapchains replaced on resize, queued under the frame index whose fence says they are no longer in use
+	std::vector<std::vector<RetiredSwapchain>> retiredSwapchains{std::vector<std::vector<RetiredSwapchain>>(framesInFlight)};
+
+	// streamed model; frames render without it until the frame that acquires it from the transfer queue
+	std::uint64_t                assetUploadValue{};
+	bool                         assetsResident{};
+	std::optional<std::uint64_t> uploadWaitValue{};
+
+	// timing; the scene advances on its own thread unless benchmarking, which steps it once a frame to render the same frames every run
+	std::chrono::steady_clock::time_point startTime{std::chrono::steady_clock::now()};
+	FrameStats                            frameStats{};
+	// set by the simulation thread for each step it publishes under --idle, which waits in the event queue until there is one
+	std::atomic<bool>                     sceneMoved{true};
+	std::unique_ptr<Simulation>           simulation{makeSimulation()};
+
+	// --idle; the loop has drawn nothing since idleSince, when it has a value
+	std::optional<std::chrono::steady_clock::time_point> idleSince{};
+	std::chrono::duration<double>                        idleTime{};
 
 	// vertices
 
 	//  INSTANCE PRIVATE
 	auto               mainLoop() -> void;
+	[[nodiscard]] auto benchmarkComplete() const -> bool;
+	[[nodiscard]] auto redrawNeeded() const -> bool;
+	auto               endIdlePeriod() -> void;
+	auto               writeBenchmarkReport() const -> void;
+	[[nodiscard]] auto animationTime() const -> float;
+	[[nodiscard]] auto sceneState() const -> SceneState;
 	auto               drawFrame() -> void;
+	auto               drawOffscreenFrame() -> void;
 	[[nodiscard]] auto makeInstance() const -> vkr::Instance;
 	[[nodiscard]] auto makeDebugMessenger() const -> vkr::DebugUtilsMessengerEXT;
 	auto               makeSurface() -> vkr::SurfaceKHR;
 	auto               pickPhysicalDevice() -> vkr::PhysicalDevice;
 	[[nodiscard]] auto makeDevice() const -> vkr::Device;
-	auto               makeSwapchain() -> vkr::SwapchainKHR;
-	[[nodiscard]] auto makeImageView(vk::Image const&, vk::Format const&, vk::ImageAspectFlags const&) const -> vkr::ImageView;
+	auto               makeSwapchain(vk::SwapchainKHR oldSwapchain = {}) -> vkr::SwapchainKHR;
+	[[nodiscard]] auto makeImageView(vk::Image const&, vk::Format const&, vk::ImageAspectFlags const&, std::uint32_t) const -> vkr::ImageView;
+	[[nodiscard]] auto chooseImageFormat() const -> vk::Format;
+	[[nodiscard]] auto chooseImageExtent() const -> vk::Extent2D;
+	[[nodiscard]] auto makeOffscreenImages() const -> std::vector<ImageAndMemory>;
 	auto               makeImageViews() -> std::vector<vkr::ImageView>;
 	[[nodiscard]] auto makeShaderModule(std::span<std::byte const>) const -> vkr::ShaderModule;
+	[[nodiscard]] auto loadShader(std::filesystem::path const&, std::span<std::uint32_t const>) const -> vkr::ShaderModule;
 	[[nodiscard]] auto makeRenderPass() const -> vkr::RenderPass;
 	[[nodiscard]] auto makeDescriptorSetLayout() const -> vkr::DescriptorSetLayout;
 	[[nodiscard]] auto makeGraphicsPipeline() const -> PipelineLayoutAndPipeline;
 	auto               makeFramebuffers() -> std::vector<vkr::Framebuffer>;
 	[[nodiscard]] auto makeCommandPool() const -> vkr::CommandPool;
 	[[nodiscard]] auto makeCommandBuffers() const -> vkr::CommandBuffers;
-	auto               recordCommandBuffer(vkr::CommandBuffer const&, std::uint32_t) -> void;
+	[[nodiscard]] auto makeParallelRecorder() const -> std::unique_ptr<ParallelRecorder>;
+	[[nodiscard]] auto makeFrustumCuller() const -> std::unique_ptr<FrustumCuller>;
+	[[nodiscard]] auto makeSimulation() -> std::unique_ptr<Simulation>;
+	auto               recordCommandBuffer(vkr::CommandBuffer const&, std::uint32_t, ViewProjection const&) -> void;
+	auto               bindDrawState(vkr::CommandBuffer const&) const -> void;
+	auto               recordDraws(vkr::CommandBuffer const&, std::size_t, std::size_t) const -> void;
+	auto               acquireStreamedAssets(vkr::CommandBuffer const&) -> void;
+	auto               submitFrame(vk::Semaphore const&, vk::Semaphore const&) -> void;
+	[[nodiscard]] auto findTimestampValidBits() const -> std::uint32_t;
+	[[nodiscard]] auto makeQueryPools() const -> std::vector<FrameQueryPools>;
+	auto               collectGpuQueries(std::uint32_t) -> void;
+	auto               collectInFlightGpuQueries() -> void;
 	[[nodiscard]] auto makeSemaphores() const -> std::vector<vkr::Semaphore>;
-	[[nodiscard]] auto makeFences() const -> std::vector<vkr::Fence>;
-	auto               remakeSwapchain() -> void;
-	[[nodiscard]] auto findMemoryType(std::uint32_t, vk::MemoryPropertyFlags const&) const -> std::uint32_t;
+	auto               remakeSwapchain(std::uint32_t lastSubmittedFrame) -> void;
 	[[nodiscard]] auto makeBufferAndMemory(vk::DeviceSize, vk::BufferUsageFlags const&, vk::MemoryPropertyFlags const&) const -> BufferAndMemory;
-	auto               copyBuffer(vkr::Buffer const&, vkr::Buffer const&, vk::DeviceSize) const -> void;
-	[[nodiscard]] auto makeVertexBuffer() const -> BufferAndMemory;
-	[[nodiscard]] auto makeIndexBuffer() const -> BufferAndMemory;
-	[[nodiscard]] auto makeUniformBuffers() const -> std::vector<BufferAndMemory>;
-	auto               mapUniformBuffers() -> std::vector<void*>;
-	auto               updateUniformBuffer(std::uint32_t) const -> void;
+	[[nodiscard]] auto makeVertexBuffer(UploadBatch&) const -> BufferAndMemory;
+	[[nodiscard]] auto makeIndexBuffer(UploadBatch&) const -> BufferAndMemory;
+	auto               updateUniformBuffer(std::uint32_t) -> ViewProjection;
+	[[nodiscard]] auto makeInstanceBuffer() const -> BufferAndMemory;
+	[[nodiscard]] auto makeReadbackBuffers() const -> std::vector<BufferAndMemory>;
+	auto               mapReadbackBuffers() -> std::vector<void*>;
+	auto               writeReadback(std::uint32_t) -> void;
 	[[nodiscard]] auto makeDescriptorPool() const -> vkr::DescriptorPool;
-	auto               makeDescriptorSets() -> vkr::DescriptorSets;
-	[[nodiscard]] auto makeTextureImage(std::filesystem::path const&) const -> ImageAndMemory;
+	[[nodiscard]] auto makeDescriptorSet() const -> vkr::DescriptorSet;
+	[[nodiscard]] auto selectTextureFormat(std::filesystem::path const&) const -> vk::Format;
+	[[nodiscard]] auto makeTextureImage(UploadBatch&, std::filesystem::path const&) const -> ImageAndMemory;
+	[[nodiscard]] auto makeCompressedTextureImage(UploadBatch&, std::filesystem::path const&) const -> ImageAndMemory;
 	[[nodiscard]] auto makeImageAndMemory(std::uint32_t,
+	                                      std::uint32_t,
 	                                      std::uint32_t,
 	                                      vk::Format const&,
 	                                      vk::ImageTiling const&,
 	                                      vk::ImageUsageFlags const&,
 	                                      vk ::MemoryPropertyFlags const&) const -> ImageAndMemory;
-	[[nodiscard]] auto beginSingleTimeCommands() const -> vkr::CommandBuffer;
-	auto               endSingleTimeCommands(vkr::CommandBuffer&&) const -> void;
-	auto               transitionImageLayout(vkr::Image const&, vk::Format const&, vk::ImageLayout const&, vk::ImageLayout const&) const -> void;
-	auto               copyBufferToImage(vkr::Buffer const&, vkr::Image const&, std::uint32_t, std::uint32_t) const -> void;
+	[[nodiscard]] auto canBlitMipmaps(vk::Format const&) const -> bool;
 	[[nodiscard]] auto makeTextureImageView() const -> vkr::ImageView;
 	[[nodiscard]] auto makeTextureSampler() const -> vkr::Sampler;
 	[[nodiscard]] auto makeDepthImage() const -> ImageAndMemory;
 	[[nodiscard]] auto makeDepthImageView() const -> vkr::ImageView;
 	[[nodiscard]] auto findSupportedFormat(std::span<vk::Format const>, vk::ImageTiling const&, vk::FormatFeatureFlags const&) const -> vk::Format;
 	[[nodiscard]] auto findDepthFormat() const -> vk::Format;
-	[[nodiscard]] static auto loadModel(std::filesystem::path const&) -> VerticesAndIndices<std::uint32_t>;
+	[[nodiscard]] auto loadModel(std::filesystem::path const&) const -> Mesh;
+	[[nodiscard]] auto parseModel(std::filesystem::path const&) const -> VerticesAndIndices<std::uint32_t>;
 
 	//	STATIC PRIVATE
 	static auto chooseSwapSurfaceFormat(std::span<vk::SurfaceFormatKHR const>) -> vk::SurfaceFormatKHR;
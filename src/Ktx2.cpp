@@ -0,0 +1,229 @@
+#include "Ktx2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace HelloTriangle
+{
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr auto KTX2_IDENTIFIER = std::array<std::uint8_t, 12>{0xABu, 'K', 'T', 'X', ' ', '2', '0', 0xBBu, '\r', '\n', 0x1Au, '\n'};
+constexpr auto BLOCK_EXTENT    = std::uint32_t{4u};
+constexpr auto WRITER          = std::string_view{"vulkan_tutorial texture_encoder"};
+
+struct Ktx2Header
+{
+	std::array<std::uint8_t, 12> identifier{KTX2_IDENTIFIER};
+	std::uint32_t                vkFormat{};
+	std::uint32_t                typeSize{1u};
+	std::uint32_t                pixelWidth{};
+	std::uint32_t                pixelHeight{};
+	std::uint32_t                pixelDepth{};
+	std::uint32_t                layerCount{};
+	std::uint32_t                faceCount{1u};
+	std::uint32_t                levelCount{};
+	std::uint32_t                supercompressionScheme{};
+	std::uint32_t                dfdByteOffset{};
+	std::uint32_t                dfdByteLength{};
+	std::uint32_t                kvdByteOffset{};
+	std::uint32_t                kvdByteLength{};
+	std::uint64_t                sgdByteOffset{};
+	std::uint64_t                sgdByteLength{};
+};
+static_assert(sizeof(Ktx2Header) == 80u);
+
+struct Ktx2LevelIndex
+{
+	std::uint64_t byteOffset{};
+	std::uint64_t byteLength{};
+	std::uint64_t uncompressedByteLength{};
+};
+
+auto levelExtent(std::uint32_t const extent, std::uint32_t const level) -> std::uint32_t { return std::max(extent >> level, 1u); }
+
+auto levelByteLength(vk::Format const format, std::uint32_t const width, std::uint32_t const height) -> std::size_t
+{
+	auto const blocksWide = (width + BLOCK_EXTENT - 1u) / BLOCK_EXTENT;
+	auto const blocksHigh = (height + BLOCK_EXTENT - 1u) / BLOCK_EXTENT;
+	return std::size_t{blocksWide} * blocksHigh * blockSize(format);
+}
+
+auto alignUp(std::size_t const value, std::size_t const alignment) -> std::size_t { return (value + alignment - 1u) / alignment * alignment; }
+
+// the basic descriptor block for a 4x4 block format with a single sample covering the whole block
+auto dataFormatDescriptor(vk::Format const format) -> std::vector<std::uint32_t>
+{
+	constexpr auto KHR_DF_MODEL_BC1A      = 128u;
+	constexpr auto KHR_DF_MODEL_BC7       = 134u;
+	constexpr auto KHR_DF_PRIMARIES_BT709 = 1u;
+	constexpr auto KHR_DF_TRANSFER_LINEAR = 1u;
+	constexpr auto KHR_DF_TRANSFER_SRGB   = 2u;
+	constexpr auto KHR_DF_VERSION         = 2u;
+	constexpr auto BLOCK_BYTES            = 24u + 16u;
+
+	auto const srgb  = format == vk::Format::eBc1RgbSrgbBlock or format == vk::Format::eBc7SrgbBlock;
+	auto const model = blockSize(format) == 8u ? KHR_DF_MODEL_BC1A : KHR_DF_MODEL_BC7;
+	auto const bits  = static_cast<std::uint32_t>(blockSize(format) * 8u);
+
+	return {4u + BLOCK_BYTES,
+	        0u,
+	        KHR_DF_VERSION | BLOCK_BYTES << 16u,
+	        model | KHR_DF_PRIMARIES_BT709 << 8u | (srgb ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR) << 16u,
+	        (BLOCK_EXTENT - 1u) | (BLOCK_EXTENT - 1u) << 8u,
+	        bits / 8u,
+	        0u,
+	        (bits - 1u) << 16u,
+	        0u,
+	        0u,
+	        0xFFFF'FFFFu};
+}
+
+// a single KTXwriter entry, padded to four bytes
+auto keyValueData() -> std::vector<std::byte>
+{
+	constexpr auto key = std::string_view{"KTXwriter"};
+
+	auto const length = static_cast<std::uint32_t>(key.size() + 1u + WRITER.size() + 1u);
+	auto       data   = std::vector<std::byte>(alignUp(sizeof(length) + length, 4u));
+	std::memcpy(data.data(), &length, sizeof(length));
+	std::memcpy(data.data() + sizeof(length), key.data(), key.size());
+	std::memcpy(data.data() + sizeof(length) + key.size() + 1u, WRITER.data(), WRITER.size());
+
+	return data;
+}
+}// namespace
+
+auto blockSize(vk::Format const format) -> std::size_t
+{
+	switch (format) {
+	case vk::Format::eBc1RgbUnormBlock:
+	case vk::Format::eBc1RgbSrgbBlock: return 8u;
+	case vk::Format::eBc7UnormBlock:
+	case vk::Format::eBc7SrgbBlock: return 16u;
+	default: return 0u;
+	}
+}
+
+Ktx2Texture::Ktx2Texture(fs::path const& path)
+    : file{path}
+{
+	auto const fileBytes = file.bytes();
+	auto const invalid   = [&](std::string_view const reason)
+	{ return std::runtime_error{fmt::format("unsupported KTX2 texture {}: {}", path.string(), reason)}; };
+
+	auto header = Ktx2Header{};
+	if (fileBytes.size() < sizeof(header)) {
+		throw invalid("truncated header");
+	}
+	std::memcpy(&header, fileBytes.data(), sizeof(header));
+
+	textureFormat = static_cast<vk::Format>(header.vkFormat);
+	if (header.identifier != KTX2_IDENTIFIER) {
+		throw invalid("not a KTX2 file");
+	}
+	if (blockSize(textureFormat) == 0u or header.typeSize != 1u) {
+		throw invalid(fmt::format("format {} is not BC1 or BC7", header.vkFormat));
+	}
+	if (header.pixelWidth == 0u or header.pixelHeight == 0u or header.pixelDepth != 0u or header.layerCount > 1u or
+	    header.faceCount != 1u)
+	{
+		throw invalid("not a single 2D image");
+	}
+	if (header.supercompressionScheme != 0u) {
+		throw invalid("supercompressed");
+	}
+	if (header.levelCount == 0u or header.levelCount > mipLevelCount(header.pixelWidth, header.pixelHeight) or
+	    fileBytes.size() < sizeof(header) + header.levelCount * sizeof(Ktx2LevelIndex))
+	{
+		throw invalid("bad level count");
+	}
+
+	mipLevels.reserve(header.levelCount);
+	for (auto level = std::uint32_t{0}; level < header.levelCount; ++level) {
+		auto index = Ktx2LevelIndex{};
+		std::memcpy(&index, fileBytes.data() + sizeof(header) + level * sizeof(index), sizeof(index));
+
+		auto const width  = levelExtent(header.pixelWidth, level);
+		auto const height = levelExtent(header.pixelHeight, level);
+		if (index.byteLength != levelByteLength(textureFormat, width, height) or index.byteOffset % blockSize(textureFormat) != 0u or
+		    index.byteOffset > fileBytes.size() or index.byteLength > fileBytes.size() - index.byteOffset)
+		{
+			throw invalid(fmt::format("bad extent for level {}", level));
+		}
+
+		mipLevels.push_back({width, height, static_cast<std::size_t>(index.byteOffset)});
+	}
+}
+
+auto writeKtx2(fs::path const&                         path,
+               vk::Format const                        format,
+               std::uint32_t const                     width,
+               std::uint32_t const                     height,
+               std::span<std::vector<std::byte> const> levels) -> void
+{
+	if (blockSize(format) == 0u) {
+		throw std::invalid_argument{fmt::format("cannot write format {} to KTX2", static_cast<std::uint32_t>(format))};
+	}
+	if (levels.empty() or levels.size() > mipLevelCount(width, height)) {
+		throw std::invalid_argument{fmt::format("{} levels do not fit a {}x{} texture", levels.size(), width, height)};
+	}
+
+	auto const descriptor = dataFormatDescriptor(format);
+	auto const keyValues  = keyValueData();
+
+	auto header = Ktx2Header{.vkFormat    = static_cast<std::uint32_t>(format),
+	                         .pixelWidth  = width,
+	                         .pixelHeight = height,
+	                         .levelCount  = static_cast<std::uint32_t>(levels.size())};
+
+	header.dfdByteOffset = static_cast<std::uint32_t>(sizeof(header) + levels.size() * sizeof(Ktx2LevelIndex));
+	header.dfdByteLength = static_cast<std::uint32_t>(descriptor.size() * sizeof(std::uint32_t));
+	header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+	header.kvdByteLength = static_cast<std::uint32_t>(keyValues.size());
+
+	// level data is stored smallest first, each level aligned to its block size
+	auto indices = std::vector<Ktx2LevelIndex>(levels.size());
+	auto offset  = std::size_t{header.kvdByteOffset + header.kvdByteLength};
+	for (auto level = levels.size(); level-- > 0u;) {
+		auto const& data        = levels[level];
+		auto const  levelWidth  = levelExtent(width, static_cast<std::uint32_t>(level));
+		auto const  levelHeight = levelExtent(height, static_cast<std::uint32_t>(level));
+		if (data.size() != levelByteLength(format, levelWidth, levelHeight)) {
+			throw std::invalid_argument{fmt::format("level {} has {} bytes of blocks", level, data.size())};
+		}
+
+		offset         = alignUp(offset, blockSize(format));
+		indices[level] = {offset, data.size(), data.size()};
+		offset += data.size();
+	}
+
+	auto stream  = std::ofstream{path, std::ios::binary | std::ios::trunc};
+	auto written = std::size_t{0};
+	auto write   = [&](void const* const data, std::size_t const size)
+	{
+		stream.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+		written += size;
+	};
+
+	write(&header, sizeof(header));
+	write(indices.data(), indices.size() * sizeof(Ktx2LevelIndex));
+	write(descriptor.data(), descriptor.size() * sizeof(std::uint32_t));
+	write(keyValues.data(), keyValues.size());
+	for (auto level = levels.size(); level-- > 0u;) {
+		static constexpr auto padding = std::array<std::byte, 16>{};
+		write(padding.data(), indices[level].byteOffset - written);
+		write(levels[level].data(), levels[level].size());
+	}
+
+	if (not stream) {
+		throw std::runtime_error{fmt::format("failed to write {}", path.string())};
+	}
+}
+}// namespace HelloTriangle
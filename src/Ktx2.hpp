@@ -0,0 +1,41 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include "MipChain.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace HelloTriangle
+{
+// A KTX2 texture read in place from a memory-mapped file. Only what texture_encoder writes is accepted: one 2D image in a
+// block-compressed format with one or more mip levels and no supercompression.
+class Ktx2Texture
+{
+public:
+	explicit Ktx2Texture(std::filesystem::path const&);
+
+	[[nodiscard]] auto format() const -> vk::Format { return textureFormat; }
+	[[nodiscard]] auto width() const -> std::uint32_t { return levels().front().width; }
+	[[nodiscard]] auto height() const -> std::uint32_t { return levels().front().height; }
+	// level 0 first; offsets are into bytes() and satisfy the copy alignment of the format's blocks
+	[[nodiscard]] auto levels() const -> std::span<MipLevel const> { return mipLevels; }
+	[[nodiscard]] auto bytes() const -> std::span<std::byte const> { return file.bytes(); }
+
+private:
+	MappedFile            file;
+	vk::Format            textureFormat{};
+	std::vector<MipLevel> mipLevels;
+};
+
+// bytes of one 4x4 block, or 0 for formats Ktx2Texture does not accept
+[[nodiscard]] auto blockSize(vk::Format) -> std::size_t;
+
+// Writes levels (level 0 first, each a row-major run of blocks) as a KTX2 file with a basic data format descriptor.
+auto writeKtx2(std::filesystem::path const&, vk::Format, std::uint32_t width, std::uint32_t height, std::span<std::vector<std::byte> const> levels)
+    -> void;
+}// namespace HelloTriangle
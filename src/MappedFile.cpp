@@ -0,0 +1,114 @@
+#include "MappedFile.hpp"
+
+#include <fmt/format.h>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace HelloTriangle
+{
+MappedFile::MappedFile(std::filesystem::path const& path)
+{
+	auto const fail = [&path](std::string_view const what) { return std::runtime_error{fmt::format("failed to {} {}", what, path.string())}; };
+
+#ifdef _WIN32
+	auto const file =
+	    CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw fail("open");
+	}
+
+	auto fileSize = LARGE_INTEGER{};
+	if (GetFileSizeEx(file, &fileSize) == 0) {
+		CloseHandle(file);
+		throw fail("stat");
+	}
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+
+	if (size > 0u) {
+		mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle != nullptr) {
+			data = static_cast<std::byte const*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+	CloseHandle(file);
+
+	if (size > 0u and data == nullptr) {
+		unmap();
+		throw fail("map");
+	}
+#else
+	auto const file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0) {
+		throw fail("open");
+	}
+
+	struct stat status{};
+	if (fstat(file, &status) != 0) {
+		close(file);
+		throw fail("stat");
+	}
+	size = static_cast<std::size_t>(status.st_size);
+
+	// mmap rejects empty mappings; an empty file is simply an empty view
+	if (size > 0u) {
+		auto* const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			close(file);
+			throw fail("map");
+		}
+		data = static_cast<std::byte const*>(mapping);
+		madvise(mapping, size, MADV_SEQUENTIAL);
+	}
+	close(file);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+	if (this != &other) {
+		unmap();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0u);
+#ifdef _WIN32
+		mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+	}
+
+	return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+auto MappedFile::unmap() -> void
+{
+#ifdef _WIN32
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	mappingHandle = nullptr;
+#else
+	if (data != nullptr) {
+		munmap(const_cast<std::byte*>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0u;
+}
+}// namespace HelloTriangle
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace HelloTriangle
+{
+// Read-only memory mapping of a whole file; the view stays valid for as long as the object lives.
+class MappedFile
+{
+public:
+	explicit MappedFile(std::filesystem::path const&);
+	MappedFile(MappedFile const&) = delete;
+	MappedFile(MappedFile&&) noexcept;
+	auto operator=(MappedFile const&) -> MappedFile& = delete;
+	auto operator=(MappedFile&&) noexcept -> MappedFile&;
+	~MappedFile();
+
+	[[nodiscard]] auto bytes() const -> std::span<std::byte const> { return {data, size}; }
+
+private:
+	std::byte const* data{};
+	std::size_t      size{};
+#ifdef _WIN32
+	void* mappingHandle{};
+#endif
+
+	auto unmap() -> void;
+};
+}// namespace HelloTriangle
@@ -0,0 +1,156 @@
+#include "Mesh.hpp"
+
+#include <algorithm>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace HelloTriangle
+{
+auto splitForIndexType(VerticesAndIndices<std::uint32_t> arrays) -> std::pair<VerticesAndIndices<MeshIndex>, std::vector<Submesh>>
+{
+	constexpr auto maxVertices = std::size_t{std::numeric_limits<MeshIndex>::max()};
+
+	if (arrays.vertexIndices.size() % 3u != 0u) {
+		throw std::invalid_argument{"index count is not a multiple of three"};
+	}
+	if (std::ranges::any_of(arrays.vertexIndices, [&](auto const index) { return index >= arrays.vertices.size(); })) {
+		throw std::out_of_range{"index refers past the end of the vertex array"};
+	}
+
+	auto result = VerticesAndIndices<MeshIndex>{};
+	result.vertexIndices.reserve(arrays.vertexIndices.size());
+
+	if (arrays.vertices.size() <= maxVertices) {
+		auto const whole = Submesh{0u, static_cast<std::uint32_t>(arrays.vertexIndices.size()), 0};
+
+		result.vertices = std::move(arrays.vertices);
+		std::ranges::transform(
+		    arrays.vertexIndices, std::back_inserter(result.vertexIndices), [](auto const index) { return static_cast<MeshIndex>(index); });
+
+		return {std::move(result), {whole}};
+	}
+
+	// each source vertex's index within the current submesh, valid while its generation matches the submesh's
+	auto localIndices = std::vector<MeshIndex>(arrays.vertices.size());
+	auto generations  = std::vector<std::uint32_t>(arrays.vertices.size(), 0u);
+	auto generation   = std::uint32_t{1u};
+	auto submeshes    = std::vector<Submesh>{};
+	auto firstVertex  = std::size_t{0};
+
+	auto const startSubmesh = [&]
+	{
+		firstVertex = result.vertices.size();
+		++generation;
+		submeshes.push_back({static_cast<std::uint32_t>(result.vertexIndices.size()), 0u, static_cast<std::int32_t>(firstVertex)});
+	};
+
+	startSubmesh();
+	for (auto triangle = std::size_t{0}; triangle < arrays.vertexIndices.size(); triangle += 3u) {
+		auto const corners     = std::span{arrays.vertexIndices}.subspan(triangle, 3u);
+		auto const newVertices = std::ranges::count_if(corners, [&](auto const index) { return generations[index] != generation; });
+
+		// a conservative count: a triangle repeating a new vertex only needs it once
+		if (result.vertices.size() - firstVertex + static_cast<std::size_t>(newVertices) > maxVertices) {
+			startSubmesh();
+		}
+
+		for (auto const index : corners) {
+			if (generations[index] != generation) {
+				generations[index]  = generation;
+				localIndices[index] = static_cast<MeshIndex>(result.vertices.size() - firstVertex);
+				result.vertices.push_back(arrays.vertices[index]);
+			}
+			result.vertexIndices.push_back(localIndices[index]);
+		}
+		submeshes.back().indexCount += 3u;
+	}
+
+	return {std::move(result), std::move(submeshes)};
+}
+
+auto quantiseVertices(std::span<Vertex const> const vertices) -> std::pair<std::vector<QuantisedVertex>, VertexDequantisation>
+{
+	auto lower = vertices.empty() ? glm::vec3{0.0f} : vertices.front().position;
+	auto upper = lower;
+	for (auto const& vertex : vertices) {
+		lower = glm::min(lower, vertex.position);
+		upper = glm::max(upper, vertex.position);
+	}
+
+	auto const extent = upper - lower;
+	// a flat axis encodes as zero and decodes through a zero scale
+	auto const encode = [&](float const value, float const low, float const size)
+	{ return glm::packUnorm1x16(size > 0.0f ? (value - low) / size : 0.0f); };
+
+	auto quantised = std::vector<QuantisedVertex>{};
+	quantised.reserve(vertices.size());
+	std::ranges::transform(vertices,
+	                       std::back_inserter(quantised),
+	                       [&](Vertex const& vertex)
+	                       {
+		                       return QuantisedVertex{{encode(vertex.position.x, lower.x, extent.x),
+		                                               encode(vertex.position.y, lower.y, extent.y),
+		                                               encode(vertex.position.z, lower.z, extent.z),
+		                                               0u},
+		                                              {glm::packHalf1x16(vertex.texCoord.x), glm::packHalf1x16(vertex.texCoord.y)}};
+	                       });
+
+	return {std::move(quantised), VertexDequantisation{extent, lower}};
+}
+
+auto boundingSphere(std::span<MeshVertex const> const vertices) -> BoundingSphere
+{
+	auto const position = []<typename VertexType>(VertexType const& vertex) -> glm::vec3
+	{
+		if constexpr (std::same_as<VertexType, QuantisedVertex>) {
+			return {glm::unpackUnorm1x16(vertex.position[0]),
+			        glm::unpackUnorm1x16(vertex.position[1]),
+			        glm::unpackUnorm1x16(vertex.position[2])};
+		} else {
+			return vertex.position;
+		}
+	};
+
+	if (vertices.empty()) {
+		return {};
+	}
+
+	auto lower = position(vertices.front());
+	auto upper = lower;
+	for (auto const& vertex : vertices) {
+		lower = glm::min(lower, position(vertex));
+		upper = glm::max(upper, position(vertex));
+	}
+
+	auto const centre = (lower + upper) / 2.0f;
+	auto       radius = 0.0f;
+	for (auto const& vertex : vertices) {
+		radius = std::max(radius, glm::distance(centre, position(vertex)));
+	}
+
+	return {centre, radius};
+}
+
+Mesh::Mesh(VerticesAndIndices<std::uint32_t> arrays)
+{
+	auto [split, submeshes] = splitForIndexType(std::move(arrays));
+	ownedIndices            = std::move(split.vertexIndices);
+	ownedSubmeshes          = std::move(submeshes);
+
+#if defined(QUANTISED_VERTICES)
+	std::tie(ownedVertices, positionTransform) = quantiseVertices(split.vertices);
+#else
+	ownedVertices = std::move(split.vertices);
+#endif
+
+	vertexView  = ownedVertices;
+	indexView   = ownedIndices;
+	submeshView = ownedSubmeshes;
+}
+}// namespace HelloTriangle
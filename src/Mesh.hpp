@@ -0,0 +1,157 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace HelloTriangle
+{
+// Full-precision vertex, as the loaders and mesh passes produce it; also the GPU layout unless QUANTISED_VERTICES is defined.
+struct Vertex
+{
+	glm::vec3 position{};
+	glm::vec3 colour{};
+	glm::vec2 texCoord{};
+
+	// descriptions
+	static consteval auto getBindingDescription() -> vk::VertexInputBindingDescription { return {0, sizeof(Vertex)}; }
+
+	static consteval auto getAttributeDescriptions() -> std::array<vk::VertexInputAttributeDescription, 3>
+	{
+		constexpr auto positionAttribute =
+		    vk::VertexInputAttributeDescription{{}, {}, vk::Format::eR32G32B32Sfloat, static_cast<unsigned>(offsetof(Vertex, position))};
+		constexpr auto colourAttribute =
+		    vk::VertexInputAttributeDescription{1, {}, vk::Format::eR32G32B32Sfloat, static_cast<unsigned>(offsetof(Vertex, colour))};
+		constexpr auto texCoordAttribute =
+		    vk::VertexInputAttributeDescription{2u, 0u, vk::Format::eR32G32Sfloat, static_cast<unsigned>(offsetof(Vertex, texCoord))};
+
+		return {positionAttribute, colourAttribute, texCoordAttribute};
+	}
+
+	constexpr auto operator==(Vertex const& other) const -> bool
+	{
+		return position == other.position && colour == other.colour && texCoord == other.texCoord;
+	}
+};
+
+// 12 bytes against Vertex's 32: the position as 16-bit unorm within the mesh's bounding box, its fourth component padding so the
+// attribute can use a widely supported four-channel format, and the UV as half floats. The constant colour stream is dropped;
+// shaders built with QUANTISED_VERTICES use white instead.
+struct QuantisedVertex
+{
+	std::array<std::uint16_t, 4> position{};
+	std::array<std::uint16_t, 2> texCoord{};
+
+	// descriptions
+	static consteval auto getBindingDescription() -> vk::VertexInputBindingDescription { return {0u, sizeof(QuantisedVertex)}; }
+
+	static consteval auto getAttributeDescriptions() -> std::array<vk::VertexInputAttributeDescription, 2>
+	{
+		constexpr auto positionAttribute = vk::VertexInputAttributeDescription{
+		    0u, 0u, vk::Format::eR16G16B16A16Unorm, static_cast<unsigned>(offsetof(QuantisedVertex, position))};
+		constexpr auto texCoordAttribute =
+		    vk::VertexInputAttributeDescription{2u, 0u, vk::Format::eR16G16Sfloat, static_cast<unsigned>(offsetof(QuantisedVertex, texCoord))};
+
+		return {positionAttribute, texCoordAttribute};
+	}
+};
+
+// the layout vertex buffers, the mesh cache and the pipeline's vertex input use; the shaders are compiled to match
+#if defined(QUANTISED_VERTICES)
+using MeshVertex = QuantisedVertex;
+#else
+using MeshVertex = Vertex;
+#endif
+
+// Takes a decoded MeshVertex position back to model space: offset + scale * position. The identity for the float layout.
+struct VertexDequantisation
+{
+	glm::vec3 scale{1.0f};
+	glm::vec3 offset{0.0f};
+};
+
+// A sphere enclosing every vertex, in decoded MeshVertex space: VertexDequantisation, or a matrix that includes it, maps it to model space.
+struct BoundingSphere
+{
+	glm::vec3 centre{};
+	float     radius{};
+};
+
+template<typename IndexType>
+    requires std::unsigned_integral<IndexType>
+struct VerticesAndIndices
+{
+	std::vector<Vertex>    vertices;
+	std::vector<IndexType> vertexIndices;
+};
+
+// Index buffers are always 16-bit; a mesh with more vertices than that addresses is split into submeshes that each fit.
+using MeshIndex = std::uint16_t;
+
+inline constexpr auto MESH_INDEX_TYPE = vk::IndexTypeValue<MeshIndex>::value;
+
+// One draw: indexCount indices from firstIndex, each relative to vertexOffset in the vertex buffer.
+struct Submesh
+{
+	std::uint32_t firstIndex{};
+	std::uint32_t indexCount{};
+	std::int32_t  vertexOffset{};
+};
+
+// Narrows the indices to MeshIndex, splitting the triangles, in order, into submeshes of at most 65535 vertices each (the
+// all-ones index is left unused, as it would restart primitives on pipelines that enable that). Vertices shared between
+// submeshes are duplicated so each submesh's vertices are contiguous.
+[[nodiscard]] auto splitForIndexType(VerticesAndIndices<std::uint32_t>) -> std::pair<VerticesAndIndices<MeshIndex>, std::vector<Submesh>>;
+
+// Quantises positions against the vertices' bounding box and UVs to half floats.
+[[nodiscard]] auto quantiseVertices(std::span<Vertex const>) -> std::pair<std::vector<QuantisedVertex>, VertexDequantisation>;
+
+// Centred on the vertices' bounding box, which for most models is close to the smallest enclosing sphere.
+[[nodiscard]] auto boundingSphere(std::span<MeshVertex const>) -> BoundingSphere;
+
+// Final mesh arrays, either owned after parsing a model or viewed in place inside a memory-mapped cache file.
+// Moving keeps the views valid: a moved vector and a moved mapping both keep their storage.
+class Mesh
+{
+public:
+	// splits the mesh for MeshIndex and encodes the vertices into the MeshVertex layout
+	explicit Mesh(VerticesAndIndices<std::uint32_t> arrays);
+
+	Mesh(MappedFile file,
+	     std::span<MeshVertex const> const vertices,
+	     std::span<MeshIndex const> const  indices,
+	     std::span<Submesh const> const    submeshes,
+	     VertexDequantisation const&       dequantisation)
+	    : mapping{std::move(file)},
+	      vertexView{vertices},
+	      indexView{indices},
+	      submeshView{submeshes},
+	      positionTransform{dequantisation}
+	{}
+
+	[[nodiscard]] auto vertices() const -> std::span<MeshVertex const> { return vertexView; }
+	[[nodiscard]] auto indices() const -> std::span<MeshIndex const> { return indexView; }
+	[[nodiscard]] auto submeshes() const -> std::span<Submesh const> { return submeshView; }
+	[[nodiscard]] auto dequantisation() const -> VertexDequantisation const& { return positionTransform; }
+
+private:
+	std::vector<MeshVertex>     ownedVertices{};
+	std::vector<MeshIndex>      ownedIndices{};
+	std::vector<Submesh>        ownedSubmeshes{};
+	std::optional<MappedFile>   mapping{};
+	std::span<MeshVertex const> vertexView{};
+	std::span<MeshIndex const>  indexView{};
+	std::span<Submesh const>    submeshView{};
+	VertexDequantisation        positionTransform{};
+};
+}// namespace HelloTriangle
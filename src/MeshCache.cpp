@@ -0,0 +1,125 @@
+#include "MeshCache.hpp"
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr auto CACHE_MAGIC   = std::array{'H', 'T', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr auto CACHE_VERSION = std::uint32_t{4u};
+
+struct CacheHeader
+{
+	std::array<char, 8>  magic{CACHE_MAGIC};
+	std::uint32_t        version{CACHE_VERSION};
+	std::uint32_t        indexSize{};
+	std::uint64_t        layoutHash{};
+	std::uint64_t        sourceHash{};
+	std::uint64_t        variant{};
+	std::uint64_t        vertexCount{};
+	std::uint64_t        indexCount{};
+	std::uint64_t        submeshCount{};
+	VertexDequantisation dequantisation{};
+};
+// the arrays follow the header as submeshes, vertices, then indices; each size keeps the next array aligned
+static_assert(sizeof(CacheHeader) % alignof(Submesh) == 0u and sizeof(Submesh) % alignof(MeshVertex) == 0u and
+              sizeof(MeshVertex) % alignof(MeshIndex) == 0u);
+
+// any change to MeshVertex's size, attribute formats or offsets invalidates every entry
+auto vertexLayoutHash() -> std::uint64_t
+{
+	constexpr auto binding    = MeshVertex::getBindingDescription();
+	constexpr auto attributes = MeshVertex::getAttributeDescriptions();
+
+	return hashBytes(std::as_bytes(std::span{attributes}), hashBytes(std::as_bytes(std::span{&binding, 1u})));
+}
+
+auto sourceHash(fs::path const& source) -> std::uint64_t { return hashBytes(MappedFile{source}.bytes()); }
+}// namespace
+
+MeshCache::MeshCache(fs::path cacheDirectory, std::uint64_t const processingVariant)
+    : directory{std::move(cacheDirectory)},
+      variant{processingVariant}
+{}
+
+auto MeshCache::entryPath(fs::path const& source) const -> fs::path { return directory / source.filename().replace_extension(".mesh"); }
+
+auto MeshCache::find(fs::path const& source) const -> std::optional<Mesh>
+{
+	auto const path = entryPath(source);
+	if (auto error = std::error_code{}; not fs::is_regular_file(path, error)) {
+		return {};
+	}
+
+	auto       file  = MappedFile{path};
+	auto const bytes = file.bytes();
+
+	auto header = CacheHeader{};
+	if (bytes.size() < sizeof(header)) {
+		return {};
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	auto const submeshBytes = header.submeshCount * sizeof(Submesh);
+	auto const vertexBytes  = header.vertexCount * sizeof(MeshVertex);
+	auto const indexBytes   = header.indexCount * sizeof(MeshIndex);
+	if (header.magic != CACHE_MAGIC or header.version != CACHE_VERSION or header.indexSize != sizeof(MeshIndex) or
+	    header.layoutHash != vertexLayoutHash() or header.variant != variant or
+	    bytes.size() != sizeof(header) + submeshBytes + vertexBytes + indexBytes or header.sourceHash != sourceHash(source))
+	{
+		return {};
+	}
+
+	auto const submeshData = reinterpret_cast<Submesh const*>(bytes.data() + sizeof(header));
+	auto const vertexData  = reinterpret_cast<MeshVertex const*>(bytes.data() + sizeof(header) + submeshBytes);
+	auto const indexData   = reinterpret_cast<MeshIndex const*>(bytes.data() + sizeof(header) + submeshBytes + vertexBytes);
+
+	return Mesh{std::move(file),
+	            std::span{vertexData, header.vertexCount},
+	            std::span{indexData, header.indexCount},
+	            std::span{submeshData, header.submeshCount},
+	            header.dequantisation};
+}
+
+auto MeshCache::store(fs::path const& source, Mesh const& mesh) const -> void
+{
+	auto const header = CacheHeader{.indexSize      = sizeof(MeshIndex),
+	                                .layoutHash     = vertexLayoutHash(),
+	                                .sourceHash     = sourceHash(source),
+	                                .variant        = variant,
+	                                .vertexCount    = mesh.vertices().size(),
+	                                .indexCount     = mesh.indices().size(),
+	                                .submeshCount   = mesh.submeshes().size(),
+	                                .dequantisation = mesh.dequantisation()};
+
+	fs::create_directories(directory);
+	auto const path          = entryPath(source);
+	auto const temporaryPath = fs::path{path}.concat(".tmp");
+
+	{
+		auto stream = std::ofstream{temporaryPath, std::ios::binary | std::ios::trunc};
+		stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<char const*>(mesh.submeshes().data()), static_cast<std::streamsize>(mesh.submeshes().size_bytes()));
+		stream.write(reinterpret_cast<char const*>(mesh.vertices().data()), static_cast<std::streamsize>(mesh.vertices().size_bytes()));
+		stream.write(reinterpret_cast<char const*>(mesh.indices().data()), static_cast<std::streamsize>(mesh.indices().size_bytes()));
+
+		if (not stream) {
+			throw std::runtime_error{fmt::format("failed to write mesh cache entry {}", temporaryPath.string())};
+		}
+	}
+
+	fs::rename(temporaryPath, path);
+}
+}// namespace HelloTriangle
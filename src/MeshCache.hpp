@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace HelloTriangle
+{
+// On-disk cache of final mesh arrays. An entry is keyed by a hash of the source file's contents and of the vertex layout, and is
+// memory-mapped on load so that a hit costs one hash of the source file and no per-vertex work.
+class MeshCache
+{
+public:
+	// variant names the processing applied after parsing; an entry written under another variant is a miss
+	explicit MeshCache(std::filesystem::path directory, std::uint64_t variant = 0u);
+
+	[[nodiscard]] auto find(std::filesystem::path const& source) const -> std::optional<Mesh>;
+	// written to a temporary file and renamed into place, so concurrent readers never see a partial entry
+	auto               store(std::filesystem::path const& source, Mesh const&) const -> void;
+
+private:
+	std::filesystem::path directory;
+	std::uint64_t         variant;
+
+	[[nodiscard]] auto entryPath(std::filesystem::path const& source) const -> std::filesystem::path;
+};
+}// namespace HelloTriangle
@@ -0,0 +1,330 @@
+#include "MeshOptimiser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace HelloTriangle
+{
+namespace
+{
+// Forsyth's scoring: the three most recent vertices score a flat amount so the next triangle does not simply reuse the last
+// one's edge, older cache entries decay with position, and vertices with few remaining triangles are boosted to finish them off
+constexpr auto FORSYTH_CACHE_SIZE  = 32u;
+constexpr auto LAST_TRIANGLE_SCORE = 0.75f;
+constexpr auto CACHE_DECAY_POWER   = 1.5f;
+constexpr auto VALENCE_BOOST_SCALE = 2.0f;
+constexpr auto VALENCE_BOOST_POWER = -0.5f;
+constexpr auto NOT_IN_CACHE        = std::numeric_limits<std::uint32_t>::max();
+constexpr auto NO_TRIANGLE         = std::numeric_limits<std::size_t>::max();
+constexpr auto NO_VERTEX           = std::numeric_limits<std::uint32_t>::max();
+
+auto checkIndices(std::span<std::uint32_t const> const indices, std::size_t const vertexCount) -> void
+{
+	if (indices.size() % 3u != 0u) {
+		throw std::invalid_argument{"index count is not a multiple of three"};
+	}
+	if (std::ranges::any_of(indices, [vertexCount](auto const index) { return index >= vertexCount; })) {
+		throw std::out_of_range{"index refers past the end of the vertex array"};
+	}
+}
+
+auto vertexScore(std::uint32_t const cachePosition, std::uint32_t const remainingTriangles) -> float
+{
+	if (remainingTriangles == 0u) {
+		return -1.0f;
+	}
+
+	auto score = 0.0f;
+	if (cachePosition < 3u) {
+		score = LAST_TRIANGLE_SCORE;
+	} else if (cachePosition < FORSYTH_CACHE_SIZE) {
+		auto const scaler = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3u);
+		score             = std::pow(1.0f - static_cast<float>(cachePosition - 3u) * scaler, CACHE_DECAY_POWER);
+	}
+
+	return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), VALENCE_BOOST_POWER);
+}
+
+// FIFO cache simulation by timestamps: a vertex is resident while fewer than cacheSize misses have happened since its own
+class FifoCache
+{
+public:
+	FifoCache(std::size_t const vertexCount, std::uint32_t const size) : cacheSize{size}, insertedAt(vertexCount, 0u) {}
+
+	// returns the misses the triangle incurs
+	auto add(std::span<std::uint32_t const, 3> const triangle) -> std::uint32_t
+	{
+		auto misses = 0u;
+		for (auto const vertex : triangle) {
+			if (clock - insertedAt[vertex] >= cacheSize) {
+				insertedAt[vertex] = clock++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	auto flush() -> void { clock += cacheSize + 1u; }
+
+private:
+	std::uint32_t            cacheSize;
+	std::size_t              clock{cacheSize + 1u};
+	std::vector<std::size_t> insertedAt;
+};
+
+auto triangleAt(std::span<std::uint32_t const> const indices, std::size_t const triangle) -> std::span<std::uint32_t const, 3>
+{
+	return indices.subspan(3u * triangle).first<3>();
+}
+}// namespace
+
+auto analyseVertexCache(std::span<std::uint32_t const> const indices, std::size_t const vertexCount, std::uint32_t const cacheSize)
+    -> VertexCacheStatistics
+{
+	checkIndices(indices, vertexCount);
+
+	auto cache          = FifoCache{vertexCount, cacheSize};
+	auto used           = std::vector<bool>(vertexCount);
+	auto result         = VertexCacheStatistics{};
+	auto uniqueVertices = std::size_t{0};
+
+	for (auto triangle = std::size_t{0}; triangle < indices.size() / 3u; ++triangle) {
+		result.transformedVertices += cache.add(triangleAt(indices, triangle));
+	}
+	for (auto const index : indices) {
+		uniqueVertices += used[index] ? 0u : 1u;
+		used[index] = true;
+	}
+
+	auto const triangleCount = indices.size() / 3u;
+	result.acmr = triangleCount == 0u ? 0.0f : static_cast<float>(result.transformedVertices) / static_cast<float>(triangleCount);
+	result.atvr = uniqueVertices == 0u ? 0.0f : static_cast<float>(result.transformedVertices) / static_cast<float>(uniqueVertices);
+
+	return result;
+}
+
+auto optimiseVertexCache(std::span<std::uint32_t> const indices, std::size_t const vertexCount) -> void
+{
+	checkIndices(indices, vertexCount);
+
+	auto const triangleCount = indices.size() / 3u;
+	if (triangleCount == 0u) {
+		return;
+	}
+
+	// each vertex's triangles, packed; the first remainingTriangles entries of a vertex's range are the ones not yet emitted
+	auto remainingTriangles = std::vector<std::uint32_t>(vertexCount, 0u);
+	for (auto const index : indices) {
+		++remainingTriangles[index];
+	}
+	auto adjacencyOffsets = std::vector<std::size_t>(vertexCount + 1u, 0u);
+	std::inclusive_scan(std::begin(remainingTriangles), std::end(remainingTriangles), std::next(std::begin(adjacencyOffsets)));
+	auto adjacency = std::vector<std::size_t>(indices.size());
+	{
+		auto fill = std::vector<std::size_t>(std::begin(adjacencyOffsets), std::prev(std::end(adjacencyOffsets)));
+		for (auto i = std::size_t{0}; i < indices.size(); ++i) {
+			adjacency[fill[indices[i]]++] = i / 3u;
+		}
+	}
+
+	auto cachePositions = std::vector<std::uint32_t>(vertexCount, NOT_IN_CACHE);
+	auto vertexScores   = std::vector<float>(vertexCount);
+	for (auto vertex = std::size_t{0}; vertex < vertexCount; ++vertex) {
+		vertexScores[vertex] = vertexScore(NOT_IN_CACHE, remainingTriangles[vertex]);
+	}
+
+	auto triangleScores = std::vector<float>(triangleCount);
+	auto emitted        = std::vector<bool>(triangleCount);
+	for (auto triangle = std::size_t{0}; triangle < triangleCount; ++triangle) {
+		auto const corners       = triangleAt(indices, triangle);
+		triangleScores[triangle] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+	}
+
+	auto const input = std::vector<std::uint32_t>(std::begin(indices), std::end(indices));
+	auto       cache = std::vector<std::uint32_t>{};
+	auto       next  = std::vector<std::uint32_t>{};
+	cache.reserve(FORSYTH_CACHE_SIZE + 3u);
+	next.reserve(FORSYTH_CACHE_SIZE + 3u);
+
+	auto best   = static_cast<std::size_t>(std::distance(std::begin(triangleScores), std::ranges::max_element(triangleScores)));
+	auto cursor = std::size_t{0};
+
+	for (auto output = std::size_t{0}; output < triangleCount; ++output) {
+		// nothing in the cache has triangles left: restart from the first triangle not yet emitted
+		if (best == NO_TRIANGLE) {
+			while (emitted[cursor]) {
+				++cursor;
+			}
+			best = cursor;
+		}
+
+		auto const corners = triangleAt(input, best);
+		std::ranges::copy(corners, std::begin(indices) + static_cast<std::ptrdiff_t>(3u * output));
+		emitted[best] = true;
+
+		for (auto const vertex : corners) {
+			auto const begin = std::begin(adjacency) + static_cast<std::ptrdiff_t>(adjacencyOffsets[vertex]);
+			auto const end   = begin + remainingTriangles[vertex];
+			std::iter_swap(std::find(begin, end, best), std::prev(end));
+			--remainingTriangles[vertex];
+		}
+
+		// the triangle's vertices move to the front; whatever falls off the end leaves the cache
+		next.clear();
+		for (auto const vertex : corners) {
+			if (std::ranges::find(next, vertex) == std::end(next)) {
+				next.push_back(vertex);
+			}
+		}
+		std::ranges::copy_if(
+		    cache, std::back_inserter(next), [&](auto const vertex) { return std::ranges::find(corners, vertex) == std::end(corners); });
+		for (auto position = std::uint32_t{0}; position < next.size(); ++position) {
+			cachePositions[next[position]] = position < FORSYTH_CACHE_SIZE ? position : NOT_IN_CACHE;
+		}
+
+		best           = NO_TRIANGLE;
+		auto bestScore = -std::numeric_limits<float>::infinity();
+		for (auto const vertex : next) {
+			auto const score = vertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+			auto const delta = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+
+			auto const begin = adjacencyOffsets[vertex];
+			for (auto i = begin; i < begin + remainingTriangles[vertex]; ++i) {
+				auto const triangle = adjacency[i];
+				triangleScores[triangle] += delta;
+				if (cachePositions[vertex] != NOT_IN_CACHE and triangleScores[triangle] > bestScore) {
+					bestScore = triangleScores[triangle];
+					best      = triangle;
+				}
+			}
+		}
+
+		next.resize(std::min<std::size_t>(next.size(), FORSYTH_CACHE_SIZE));
+		std::swap(cache, next);
+	}
+}
+
+auto optimiseOverdraw(std::span<std::uint32_t> const indices, std::span<Vertex const> const vertices, float const threshold) -> void
+{
+	checkIndices(indices, vertices.size());
+
+	auto const triangleCount = indices.size() / 3u;
+	if (triangleCount == 0u) {
+		return;
+	}
+
+	// hard boundaries: the cache-optimised order restarts wherever a triangle shares no vertex with the cache
+	auto cache      = FifoCache{vertices.size(), 16u};
+	auto boundaries = std::vector<std::size_t>{0u};
+	auto hardMisses = std::vector<std::size_t>{0u};
+	for (auto triangle = std::size_t{0}; triangle < triangleCount; ++triangle) {
+		auto const misses = cache.add(triangleAt(indices, triangle));
+		if (misses == 3u and triangle != 0u) {
+			boundaries.push_back(triangle);
+			hardMisses.push_back(0u);
+		}
+		hardMisses.back() += misses;
+	}
+	boundaries.push_back(triangleCount);
+
+	// soft boundaries: cut a hard cluster wherever the part since the last cut is within threshold of the whole cluster's ACMR
+	auto clusters = std::vector<std::size_t>{};
+	for (auto i = std::size_t{0}; i + 1u < boundaries.size(); ++i) {
+		auto const end       = boundaries[i + 1u];
+		auto const acmrLimit = threshold * static_cast<float>(hardMisses[i]) / static_cast<float>(end - boundaries[i]);
+
+		auto clusterStart  = boundaries[i];
+		auto clusterMisses = std::size_t{0};
+		clusters.push_back(clusterStart);
+		cache.flush();
+
+		for (auto triangle = boundaries[i]; triangle + 1u < end; ++triangle) {
+			clusterMisses += cache.add(triangleAt(indices, triangle));
+
+			if (static_cast<float>(clusterMisses) <= acmrLimit * static_cast<float>(triangle + 1u - clusterStart)) {
+				clusterStart  = triangle + 1u;
+				clusterMisses = 0u;
+				clusters.push_back(clusterStart);
+				cache.flush();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// sort key: how far the cluster's area-weighted centroid lies out from the mesh's, along the cluster's mean normal
+	auto const position = [&](std::uint32_t const index) { return vertices[index].position; };
+
+	auto meshCentroid = glm::vec3{0.0f};
+	auto meshArea     = 0.0f;
+	auto centroids    = std::vector<glm::vec3>(clusters.size() - 1u, glm::vec3{0.0f});
+	auto normals      = std::vector<glm::vec3>(clusters.size() - 1u, glm::vec3{0.0f});
+	auto areas        = std::vector<float>(clusters.size() - 1u, 0.0f);
+
+	for (auto cluster = std::size_t{0}; cluster + 1u < clusters.size(); ++cluster) {
+		for (auto triangle = clusters[cluster]; triangle < clusters[cluster + 1u]; ++triangle) {
+			auto const corners = triangleAt(indices, triangle);
+			auto const a       = position(corners[0]);
+			auto const b       = position(corners[1]);
+			auto const c       = position(corners[2]);
+			auto const normal  = glm::cross(b - a, c - a);
+			auto const area    = glm::length(normal);
+			auto const centre  = (a + b + c) / 3.0f;
+
+			centroids[cluster] += centre * area;
+			normals[cluster] += normal;
+			areas[cluster] += area;
+		}
+
+		meshCentroid += centroids[cluster];
+		meshArea += areas[cluster];
+	}
+	meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+	auto keys = std::vector<std::pair<float, std::size_t>>{};
+	keys.reserve(clusters.size() - 1u);
+	for (auto cluster = std::size_t{0}; cluster + 1u < clusters.size(); ++cluster) {
+		auto const centroid   = areas[cluster] > 0.0f ? centroids[cluster] / areas[cluster] : meshCentroid;
+		auto const normalSize = glm::length(normals[cluster]);
+		auto const normal     = normalSize > 0.0f ? normals[cluster] / normalSize : glm::vec3{0.0f};
+
+		keys.emplace_back(glm::dot(centroid - meshCentroid, normal), cluster);
+	}
+	std::ranges::stable_sort(keys, std::ranges::greater{}, &std::pair<float, std::size_t>::first);
+
+	auto const input  = std::vector<std::uint32_t>(std::begin(indices), std::end(indices));
+	auto       output = std::begin(indices);
+	for (auto const& [key, cluster] : keys) {
+		auto const first = std::begin(input) + static_cast<std::ptrdiff_t>(3u * clusters[cluster]);
+		auto const last  = std::begin(input) + static_cast<std::ptrdiff_t>(3u * clusters[cluster + 1u]);
+		output           = std::copy(first, last, output);
+	}
+}
+
+auto optimiseVertexFetch(VerticesAndIndices<std::uint32_t>& mesh) -> void
+{
+	checkIndices(mesh.vertexIndices, mesh.vertices.size());
+
+	auto remap    = std::vector<std::uint32_t>(mesh.vertices.size(), NO_VERTEX);
+	auto vertices = std::vector<Vertex>{};
+	vertices.reserve(mesh.vertices.size());
+
+	for (auto& index : mesh.vertexIndices) {
+		if (remap[index] == NO_VERTEX) {
+			remap[index] = static_cast<std::uint32_t>(vertices.size());
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	mesh.vertices = std::move(vertices);
+}
+}// namespace HelloTriangle
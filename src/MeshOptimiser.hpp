@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace HelloTriangle
+{
+// Post-transform cache behaviour of an index order, simulated with a FIFO cache of cacheSize entries.
+struct VertexCacheStatistics
+{
+	std::size_t transformedVertices{};
+	// average cache miss ratio: transformed vertices per triangle, 0.5 at best for a regular grid and 3 at worst
+	float       acmr{};
+	// average transformed vertex ratio: transformed vertices per unique vertex, 1 at best
+	float       atvr{};
+};
+
+[[nodiscard]] auto analyseVertexCache(std::span<std::uint32_t const> indices, std::size_t vertexCount, std::uint32_t cacheSize = 16u)
+    -> VertexCacheStatistics;
+
+// Reorders triangles for post-transform cache locality with Forsyth's linear-speed algorithm; the vertex array is untouched.
+auto optimiseVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount) -> void;
+
+// Reorders clusters of a cache-optimised index order so that outward-facing clusters draw first, which lets early depth testing
+// reject more of what lies behind them from any viewpoint. The order is cut into clusters where it restarts anyway, and those are
+// cut further wherever a piece stays within threshold times its cluster's ACMR; a higher threshold trades cache efficiency for
+// finer sorting.
+auto optimiseOverdraw(std::span<std::uint32_t> indices, std::span<Vertex const> vertices, float threshold = 1.05f) -> void;
+
+// Renumbers vertices in the order the index buffer first references them, so vertex fetch walks memory forwards.
+auto optimiseVertexFetch(VerticesAndIndices<std::uint32_t>&) -> void;
+}// namespace HelloTriangle
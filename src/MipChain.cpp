@@ -0,0 +1,146 @@
+#include "MipChain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace HelloTriangle
+{
+namespace
+{
+constexpr auto CHANNELS = std::size_t{4u};
+// linear values index the encode table at this precision; a step is well under half an 8-bit sRGB step even near black
+constexpr auto ENCODE_STEPS = std::size_t{1u << 16u};
+
+auto srgbToLinear(float const value) -> float
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+auto linearToSrgb(float const value) -> float
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+auto decodeTable() -> std::array<float, 256> const&
+{
+	static auto const table = []
+	{
+		auto values = std::array<float, 256>{};
+		for (auto i = std::size_t{0}; i < values.size(); ++i) {
+			values[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+		}
+		return values;
+	}();
+
+	return table;
+}
+
+auto encodeTable() -> std::vector<std::uint8_t> const&
+{
+	static auto const table = []
+	{
+		auto values = std::vector<std::uint8_t>(ENCODE_STEPS);
+		for (auto i = std::size_t{0}; i < values.size(); ++i) {
+			auto const srgb = linearToSrgb(static_cast<float>(i) / static_cast<float>(ENCODE_STEPS - 1u));
+			values[i]       = static_cast<std::uint8_t>(std::lround(std::clamp(srgb, 0.0f, 1.0f) * 255.0f));
+		}
+		return values;
+	}();
+
+	return table;
+}
+
+// one destination row: each texel averages the 2x2 block above it, clamped at odd edges. This is scalar code, and stays scalar when
+// compiled: the per-channel table lookups are gathers, which neither SSE nor NEON has and which keep the compiler from vectorising
+auto downsampleRow(std::uint8_t const* const upper,
+                   std::uint8_t const* const lower,
+                   std::uint32_t const       sourceWidth,
+                   std::uint8_t* const       destination,
+                   std::uint32_t const       width) -> void
+{
+	auto const& decode = decodeTable();
+	auto const& encode = encodeTable();
+
+	for (auto x = std::uint32_t{0}; x < width; ++x) {
+		auto const left  = std::size_t{2u * x} * CHANNELS;
+		auto const right = std::size_t{std::min(2u * x + 1u, sourceWidth - 1u)} * CHANNELS;
+
+		auto sums = std::array<float, CHANNELS>{};
+		for (auto c = std::size_t{0}; c < 3u; ++c) {
+			sums[c] = decode[upper[left + c]] + decode[upper[right + c]] + decode[lower[left + c]] + decode[lower[right + c]];
+		}
+		sums[3] = static_cast<float>(upper[left + 3u] + upper[right + 3u] + lower[left + 3u] + lower[right + 3u]);
+
+		auto* const texel = destination + std::size_t{x} * CHANNELS;
+		for (auto c = std::size_t{0}; c < 3u; ++c) {
+			texel[c] = encode[static_cast<std::size_t>(sums[c] * 0.25f * static_cast<float>(ENCODE_STEPS - 1u) + 0.5f)];
+		}
+		texel[3] = static_cast<std::uint8_t>((static_cast<std::uint32_t>(sums[3]) + 2u) / 4u);
+	}
+}
+}// namespace
+
+auto mipLevelCount(std::uint32_t const width, std::uint32_t const height) -> std::uint32_t
+{
+	return static_cast<std::uint32_t>(std::bit_width(std::max({width, height, 1u})));
+}
+
+auto mipChainLevels(std::uint32_t const width, std::uint32_t const height) -> std::vector<MipLevel>
+{
+	auto levels = std::vector<MipLevel>{};
+	levels.reserve(mipLevelCount(width, height));
+
+	auto offset = std::size_t{0};
+	for (auto level = std::uint32_t{0}; level < mipLevelCount(width, height); ++level) {
+		auto const levelWidth  = std::max(width >> level, 1u);
+		auto const levelHeight = std::max(height >> level, 1u);
+		levels.push_back({levelWidth, levelHeight, offset});
+		offset += std::size_t{levelWidth} * levelHeight * CHANNELS;
+	}
+
+	return levels;
+}
+
+auto mipChainSize(std::span<MipLevel const> const levels) -> std::size_t
+{
+	return levels.empty() ? 0u : levels.back().offset + std::size_t{levels.back().width} * levels.back().height * CHANNELS;
+}
+
+auto downsampleSrgbMipChain(std::span<std::byte> const chain, std::span<MipLevel const> const levels) -> void
+{
+	if (chain.size() < mipChainSize(levels)) {
+		throw std::invalid_argument{"texel data does not cover the mip chain"};
+	}
+
+	auto const texels = reinterpret_cast<std::uint8_t*>(chain.data());
+	for (auto level = std::size_t{1}; level < levels.size(); ++level) {
+		auto const& source      = levels[level - 1u];
+		auto const& destination = levels[level];
+		auto const  sourceRow   = std::size_t{source.width} * CHANNELS;
+
+		for (auto y = std::uint32_t{0}; y < destination.height; ++y) {
+			auto const upper = texels + source.offset + std::size_t{2u * y} * sourceRow;
+			auto const lower = texels + source.offset + std::size_t{std::min(2u * y + 1u, source.height - 1u)} * sourceRow;
+
+			downsampleRow(upper, lower, source.width, texels + destination.offset + std::size_t{y} * destination.width * CHANNELS, destination.width);
+		}
+	}
+}
+
+auto buildSrgbMipChain(std::span<std::byte const> const rgba, std::uint32_t const width, std::uint32_t const height) -> MipChain
+{
+	if (rgba.size() != std::size_t{width} * height * CHANNELS) {
+		throw std::invalid_argument{"texel data does not match the image extent"};
+	}
+
+	auto chain = MipChain{{}, mipChainLevels(width, height)};
+	chain.texels.resize(mipChainSize(chain.levels));
+	std::ranges::copy(rgba, std::begin(chain.texels));
+	downsampleSrgbMipChain(chain.texels, chain.levels);
+
+	return chain;
+}
+}// namespace HelloTriangle
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace HelloTriangle
+{
+// One level of a mip chain, packed with the others into a single buffer.
+struct MipLevel
+{
+	std::uint32_t width{};
+	std::uint32_t height{};
+	std::size_t   offset{};
+};
+
+struct MipChain
+{
+	std::vector<std::byte> texels;
+	std::vector<MipLevel>  levels;
+};
+
+// levels in a full chain down to 1x1
+[[nodiscard]] auto mipLevelCount(std::uint32_t width, std::uint32_t height) -> std::uint32_t;
+
+// extents and offsets of every level down to 1x1 when the chain is packed into one buffer, and that buffer's size
+[[nodiscard]] auto mipChainLevels(std::uint32_t width, std::uint32_t height) -> std::vector<MipLevel>;
+[[nodiscard]] auto mipChainSize(std::span<MipLevel const>) -> std::size_t;
+
+// Fills levels 1 onwards of a packed chain in place from level 0, filtering as buildSrgbMipChain does; this lets the chain be built
+// directly in its final buffer.
+auto downsampleSrgbMipChain(std::span<std::byte> chain, std::span<MipLevel const> levels) -> void;
+
+// CPU fallback for when the upload queue cannot blit: 2x2 box-filters 8-bit sRGB RGBA texels down to 1x1, averaging colour in
+// linear light and alpha as stored. The filter is scalar, not SIMD. The chain starts with a copy of the input as level 0.
+[[nodiscard]] auto buildSrgbMipChain(std::span<std::byte const> rgba, std::uint32_t width, std::uint32_t height) -> MipChain;
+}// namespace HelloTriangle
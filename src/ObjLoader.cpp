@@ -0,0 +1,420 @@
+#define TINYOBJLOADER_IMPLEMENTATION
+
+#include "ObjLoader.hpp"
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <fmt/format.h>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <tiny_obj_loader.h>
+#include <utility>
+#include <vector>
+
+namespace HelloTriangle
+{
+using namespace std::string_view_literals;
+
+namespace
+{
+// below this, a chunk is not worth a thread
+constexpr auto MIN_CHUNK_BYTES = std::size_t{1u << 20u};
+constexpr auto MIN_TABLE_SLOTS = std::size_t{64u};
+
+// the table hashes vertices as raw bytes, which only works while they have no padding
+static_assert(sizeof(Vertex) == 8u * sizeof(float));
+
+// -0.0f equals 0.0f under Vertex's operator==, but not bytewise; adding zero turns it into 0.0f and leaves every other value's bytes
+// alone, so vertices that compare equal hash alike
+auto canonicalVertex(Vertex vertex) -> Vertex
+{
+	vertex.position += 0.0f;
+	vertex.colour += 0.0f;
+	vertex.texCoord += 0.0f;
+
+	return vertex;
+}
+
+auto hashVertex(Vertex const& vertex) -> std::uint64_t
+{
+	auto const canonical = canonicalVertex(vertex);
+	return hashBytes(std::as_bytes(std::span{&canonical, 1u}));
+}
+
+// An index as written in a face: absolute, or relative to the number of elements a chunk had seen when it read the face.
+struct ObjIndex
+{
+	std::int64_t value{};
+	bool         relative{};
+};
+
+struct ObjCorner
+{
+	ObjIndex position{};
+	ObjIndex texCoord{};
+};
+
+struct ObjChunk
+{
+	std::vector<float>     positions{};
+	std::vector<float>     texCoords{};
+	std::vector<ObjCorner> corners{};
+	bool                   unsupported{};
+};
+
+auto isSpace(char const c) -> bool { return c == ' ' or c == '\t'; }
+auto isDigit(char const c) -> bool { return c >= '0' and c <= '9'; }
+
+auto skipSpaces(std::string_view const text) -> std::string_view { return text.substr(std::min(text.find_first_not_of(" \t"sv), text.size())); }
+
+// Mirrors tinyobjloader's tryParseDouble step for step. A correctly rounded parse (std::from_chars) can differ from it in the
+// last bit, and both loaders have to produce the same floats.
+auto tryParseDouble(std::string_view const text, double& result) -> bool
+{
+	constexpr auto powers = std::array{1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001};
+
+	auto mantissa = 0.0;
+	auto exponent = 0;
+	auto negative = false;
+	auto it       = std::begin(text);
+	auto read     = 0;
+
+	if (it == std::end(text)) {
+		return false;
+	}
+
+	auto leadingDot = false;
+	if (*it == '+' or *it == '-') {
+		negative = *it == '-';
+		++it;
+		leadingDot = it != std::end(text) and *it == '.';
+	} else if (*it == '.') {
+		leadingDot = true;
+	} else if (not isDigit(*it)) {
+		return false;
+	}
+
+	if (not leadingDot) {
+		for (; it != std::end(text) and isDigit(*it); ++it, ++read) {
+			mantissa *= 10;
+			mantissa += static_cast<int>(*it - '0');
+		}
+		if (read == 0) {
+			return false;
+		}
+	}
+
+	if (it != std::end(text) and *it == '.') {
+		++it;
+		for (read = 1; it != std::end(text) and isDigit(*it); ++it, ++read) {
+			mantissa += static_cast<int>(*it - '0') * (read < static_cast<int>(powers.size()) ? powers.at(read) : std::pow(10.0, -read));
+		}
+	}
+
+	if (it != std::end(text) and (*it == 'e' or *it == 'E')) {
+		++it;
+		auto negativeExponent = false;
+		if (it != std::end(text) and (*it == '+' or *it == '-')) {
+			negativeExponent = *it == '-';
+			++it;
+		} else if (it == std::end(text) or not isDigit(*it)) {
+			return false;
+		}
+
+		for (read = 0; it != std::end(text) and isDigit(*it); ++it, ++read) {
+			if (exponent > std::numeric_limits<int>::max() / 10) {
+				return false;
+			}
+			exponent = exponent * 10 + static_cast<int>(*it - '0');
+		}
+		if (read == 0) {
+			return false;
+		}
+		exponent = negativeExponent ? -exponent : exponent;
+	}
+
+	result = (negative ? -1 : 1) * (exponent != 0 ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+	return true;
+}
+
+// one whitespace-delimited real, defaulting to zero like tinyobjloader's parseReal
+auto parseReal(std::string_view& text) -> float
+{
+	text            = skipSpaces(text);
+	auto const end  = std::min(text.find_first_of(" \t"sv), text.size());
+	auto       real = 0.0;
+	tryParseDouble(text.substr(0u, end), real);
+	text.remove_prefix(end);
+
+	return static_cast<float>(real);
+}
+
+// atoi semantics: optional sign, then digits up to the first non-digit
+auto parseIndex(std::string_view& text, std::size_t const elementCount, ObjIndex& index) -> bool
+{
+	auto const plus  = not text.empty() and text.front() == '+' ? 1u : 0u;
+	auto       value = 0;
+	auto const [end, error] = std::from_chars(text.data() + plus, text.data() + text.size(), value);
+	text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+
+	if (error != std::errc{} or value == 0) {
+		return false;
+	}
+
+	index = value > 0 ? ObjIndex{value - 1, false} : ObjIndex{static_cast<std::int64_t>(elementCount) + value, true};
+	return true;
+}
+
+auto parseFace(std::string_view text, ObjChunk& chunk) -> bool
+{
+	auto cornerCount = 0u;
+	auto corners     = std::array<ObjCorner, 3>{};
+
+	for (text = skipSpaces(text); not text.empty(); text = skipSpaces(text)) {
+		auto corner = ObjCorner{};
+		if (cornerCount == corners.size() or not parseIndex(text, chunk.positions.size() / 3u, corner.position)) {
+			return false;
+		}
+		if (text.empty() or text.front() != '/' or text.size() < 2u or text.at(1) == '/') {
+			return false;
+		}
+		text.remove_prefix(1u);
+		if (not parseIndex(text, chunk.texCoords.size() / 2u, corner.texCoord)) {
+			return false;
+		}
+
+		// normals are not used
+		text.remove_prefix(std::min(text.find_first_of(" \t"sv), text.size()));
+		corners.at(cornerCount++) = corner;
+	}
+
+	if (cornerCount != corners.size()) {
+		return false;
+	}
+
+	chunk.corners.insert(std::end(chunk.corners), std::begin(corners), std::end(corners));
+	return true;
+}
+
+auto parseChunk(std::string_view text) -> ObjChunk
+{
+	auto chunk = ObjChunk{};
+
+	while (not text.empty()) {
+		auto const lineEnd = std::min(text.find_first_of("\r\n"sv), text.size());
+		auto       line    = skipSpaces(text.substr(0u, lineEnd));
+		text.remove_prefix(std::min(lineEnd + 1u, text.size()));
+
+		if (line.size() < 2u) {
+			continue;
+		}
+
+		if (line.front() == 'v' and isSpace(line.at(1))) {
+			line.remove_prefix(2u);
+			for ([[maybe_unused]] auto const component : {0, 1, 2}) {
+				chunk.positions.push_back(parseReal(line));
+			}
+		} else if (line.starts_with("vt"sv) and line.size() > 2u and isSpace(line.at(2))) {
+			line.remove_prefix(3u);
+			for ([[maybe_unused]] auto const component : {0, 1}) {
+				chunk.texCoords.push_back(parseReal(line));
+			}
+		} else if (line.front() == 'f' and isSpace(line.at(1))) {
+			if (not parseFace(line.substr(2u), chunk)) {
+				chunk.unsupported = true;
+				return chunk;
+			}
+		}
+	}
+
+	return chunk;
+}
+
+auto resolve(ObjIndex const& index, std::size_t const chunkOffset, std::size_t const elementCount, std::filesystem::path const& path)
+    -> std::size_t
+{
+	auto const resolved = index.relative ? index.value + static_cast<std::int64_t>(chunkOffset) : index.value;
+	if (resolved < 0 or static_cast<std::size_t>(resolved) >= elementCount) {
+		throw std::runtime_error{fmt::format("face index out of range in {}", path.string())};
+	}
+
+	return static_cast<std::size_t>(resolved);
+}
+}// namespace
+
+MeshBuilder::MeshBuilder(std::size_t const expectedCorners)
+{
+	arrays.vertexIndices.reserve(expectedCorners);
+	rehash(std::bit_ceil(std::max(expectedCorners + expectedCorners / 3u, MIN_TABLE_SLOTS)));
+}
+
+auto MeshBuilder::addCorner(Vertex const& vertex) -> void
+{
+	// keep the load factor at or below 3/4
+	if (4u * (arrays.vertices.size() + 1u) > 3u * slots.size()) {
+		rehash(2u * slots.size());
+	}
+
+	auto const hash = hashVertex(vertex);
+	auto const tag  = static_cast<std::uint32_t>(hash >> 32u);
+	auto const mask = slots.size() - 1u;
+
+	for (auto position = hash & mask;; position = (position + 1u) & mask) {
+		auto& slot = slots[position];
+
+		if (slot.index == EMPTY) {
+			if (arrays.vertices.size() == EMPTY) {
+				throw std::length_error{"mesh has more unique vertices than a 32-bit index can address"};
+			}
+			slot = {static_cast<std::uint32_t>(arrays.vertices.size()), tag};
+			arrays.vertexIndices.push_back(slot.index);
+			arrays.vertices.push_back(vertex);
+			return;
+		}
+		if (slot.tag == tag and arrays.vertices[slot.index] == vertex) {
+			arrays.vertexIndices.push_back(slot.index);
+			return;
+		}
+	}
+}
+
+auto MeshBuilder::rehash(std::size_t const slotCount) -> void
+{
+	slots.assign(slotCount, Slot{});
+	auto const mask = slotCount - 1u;
+
+	for (auto index = std::uint32_t{0}; index < arrays.vertices.size(); ++index) {
+		auto const hash = hashVertex(arrays.vertices[index]);
+
+		auto position = hash & mask;
+		while (slots[position].index != EMPTY) {
+			position = (position + 1u) & mask;
+		}
+		slots[position] = {index, static_cast<std::uint32_t>(hash >> 32u)};
+	}
+}
+
+auto MeshBuilder::finish() && -> VerticesAndIndices<std::uint32_t> { return std::move(arrays); }
+
+auto loadObj(std::filesystem::path const& path) -> VerticesAndIndices<std::uint32_t>
+{
+	auto attributes  = tinyobj::attrib_t{};
+	auto shapes      = std::vector<tinyobj::shape_t>{};
+	auto materials   = std::vector<tinyobj::material_t>{};
+	auto warn        = std::string{};
+	auto err         = std::string{};
+	auto modelStream = std::ifstream{path};
+
+	if (!tinyobj::LoadObj(&attributes, &shapes, &materials, &warn, &err, &modelStream)) {
+		throw std::runtime_error{warn + err};
+	}
+
+	auto const cornerCount = std::accumulate(
+	    std::begin(shapes), std::end(shapes), std::size_t{0}, [](auto const sum, auto const& shape) { return sum + shape.mesh.indices.size(); });
+	auto       builder     = MeshBuilder{cornerCount};
+
+	for (auto const& shape : shapes) {
+		for (auto const& [vertex_index, normal_index, texcoord_index] : shape.mesh.indices) {
+			Vertex vertex{};
+
+			vertex.position = {attributes.vertices[3 * vertex_index + 0],
+			                   attributes.vertices[3 * vertex_index + 1],
+			                   attributes.vertices[3 * vertex_index + 2]};
+
+			vertex.texCoord = {attributes.texcoords[2 * texcoord_index + 0], 1.0f - attributes.texcoords[2 * texcoord_index + 1]};
+
+			vertex.colour = glm::vec3{1.0f};
+
+			builder.addCorner(vertex);
+		}
+	}
+
+	return std::move(builder).finish();
+}
+
+auto loadObjParallel(std::filesystem::path const& path, unsigned const threadCount) -> std::optional<VerticesAndIndices<std::uint32_t>>
+{
+	auto const file = MappedFile{path};
+	auto const text = std::string_view{reinterpret_cast<char const*>(file.bytes().data()), file.bytes().size()};
+
+	// split at line boundaries; lines never straddle two chunks
+	auto const chunkCount = std::clamp<std::size_t>(text.size() / MIN_CHUNK_BYTES, 1u, std::max(threadCount, 1u));
+	auto       bounds     = std::vector<std::size_t>{0u};
+	for (auto i = std::size_t{1}; i < chunkCount; ++i) {
+		auto const lineEnd = text.find('\n', std::max(i * text.size() / chunkCount, bounds.back()));
+		bounds.push_back(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1u);
+	}
+	bounds.push_back(text.size());
+
+	auto chunks = std::vector<ObjChunk>(chunkCount);
+	auto errors = std::vector<std::exception_ptr>(chunkCount);
+	{
+		auto workers = std::vector<std::jthread>{};
+		workers.reserve(chunkCount);
+		for (auto i = std::size_t{0}; i < chunkCount; ++i) {
+			workers.emplace_back(
+			    [&, i]
+			    {
+				    try {
+					    chunks.at(i) = parseChunk(text.substr(bounds.at(i), bounds.at(i + 1u) - bounds.at(i)));
+				    } catch (...) {
+					    errors.at(i) = std::current_exception();
+				    }
+			    });
+		}
+	}
+
+	for (auto const& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+	if (std::ranges::any_of(chunks, &ObjChunk::unsupported)) {
+		return {};
+	}
+
+	// merge the per-chunk element arrays; relative indices resolve against each chunk's starting counts
+	auto positions     = std::vector<float>{};
+	auto texCoords     = std::vector<float>{};
+	auto cornerCount   = std::size_t{0};
+	auto chunkOffsets  = std::vector<std::pair<std::size_t, std::size_t>>{};
+	chunkOffsets.reserve(chunkCount);
+	for (auto const& chunk : chunks) {
+		chunkOffsets.emplace_back(positions.size() / 3u, texCoords.size() / 2u);
+		positions.insert(std::end(positions), std::begin(chunk.positions), std::end(chunk.positions));
+		texCoords.insert(std::end(texCoords), std::begin(chunk.texCoords), std::end(chunk.texCoords));
+		cornerCount += chunk.corners.size();
+	}
+
+	auto builder = MeshBuilder{cornerCount};
+	for (auto i = std::size_t{0}; i < chunkCount; ++i) {
+		auto const [positionOffset, texCoordOffset] = chunkOffsets.at(i);
+
+		for (auto const& corner : chunks.at(i).corners) {
+			auto const p = resolve(corner.position, positionOffset, positions.size() / 3u, path);
+			auto const t = resolve(corner.texCoord, texCoordOffset, texCoords.size() / 2u, path);
+
+			auto vertex     = Vertex{};
+			vertex.position = {positions[3u * p + 0u], positions[3u * p + 1u], positions[3u * p + 2u]};
+			vertex.texCoord = {texCoords[2u * t + 0u], 1.0f - texCoords[2u * t + 1u]};
+			vertex.colour   = glm::vec3{1.0f};
+
+			builder.addCorner(vertex);
+		}
+	}
+
+	return std::move(builder).finish();
+}
+}// namespace HelloTriangle
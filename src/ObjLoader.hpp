@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace HelloTriangle
+{
+// Builds deduplicated vertex and index arrays from triangle corners, keeping vertices in first-seen order.
+// Lookups go through a flat open-addressing table of indices into the vertex array, probed linearly from a hash of the vertex's
+// bytes with -0.0f hashed as 0.0f. Candidates are compared with Vertex's operator==, so the two zeros share the vertex seen first,
+// a vertex holding a NaN is never merged, and every vertex is stored exactly as it was added.
+class MeshBuilder
+{
+public:
+	// reserves the index array, and enough table slots that expectedCorners unique vertices never trigger a rehash
+	explicit MeshBuilder(std::size_t expectedCorners = 0u);
+
+	auto               addCorner(Vertex const&) -> void;
+	[[nodiscard]] auto finish() && -> VerticesAndIndices<std::uint32_t>;
+
+private:
+	static constexpr auto EMPTY = std::uint32_t{0xffff'ffffu};
+
+	struct Slot
+	{
+		std::uint32_t index{EMPTY};
+		// upper half of the hash; the lower half picks the slot
+		std::uint32_t tag{};
+	};
+
+	auto rehash(std::size_t slotCount) -> void;
+
+	VerticesAndIndices<std::uint32_t> arrays{};
+	std::vector<Slot>                 slots{};
+};
+
+// Reference loader: tinyobjloader on a buffered stream.
+[[nodiscard]] auto loadObj(std::filesystem::path const&) -> VerticesAndIndices<std::uint32_t>;
+
+// Memory-maps the file and parses it on threadCount workers, split at line boundaries. The result is byte-identical to loadObj's:
+// the same floats, fed through MeshBuilder in the same order, which stores each vertex as first seen.
+// Returns nothing for content it leaves to loadObj: faces that are not triangles or that lack texture coordinates.
+[[nodiscard]] auto loadObjParallel(std::filesystem::path const&, unsigned threadCount) -> std::optional<VerticesAndIndices<std::uint32_t>>;
+}// namespace HelloTriangle
@@ -0,0 +1,191 @@
+#include "Options.hpp"
+
+#include <charconv>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string_view>
+
+namespace HelloTriangle
+{
+using namespace std::string_view_literals;
+
+namespace
+{
+template<typename Integral>
+auto parseInteger(std::string_view const flag, std::string_view const value) -> Integral
+{
+	auto       result         = Integral{};
+	auto const [pointer, err] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+	if (err != std::errc{} or pointer != value.data() + value.size()) {
+		throw std::invalid_argument{fmt::format("invalid value for {}: '{}'", flag, value)};
+	}
+
+	return result;
+}
+
+auto parseMeshOptimisation(std::string_view const flag, std::string_view const value) -> MeshOptimisation
+{
+	if (value == "none"sv) {
+		return MeshOptimisation::none;
+	}
+	if (value == "cache"sv) {
+		return MeshOptimisation::vertexCache;
+	}
+	if (value == "overdraw"sv) {
+		return MeshOptimisation::overdraw;
+	}
+	throw std::invalid_argument{fmt::format("invalid value for {}: '{}' (expected none, cache or overdraw)", flag, value)};
+}
+
+auto parsePresentMode(std::string_view const flag, std::string_view const value) -> PresentMode
+{
+	if (value == "auto"sv) {
+		return PresentMode::automatic;
+	}
+	if (value == "fifo"sv) {
+		return PresentMode::fifo;
+	}
+	if (value == "mailbox"sv) {
+		return PresentMode::mailbox;
+	}
+	if (value == "immediate"sv) {
+		return PresentMode::immediate;
+	}
+	throw std::invalid_argument{fmt::format("invalid value for {}: '{}' (expected auto, fifo, mailbox or immediate)", flag, value)};
+}
+}// namespace
+
+auto parseOptions(std::span<char const* const> const args) -> Options
+{
+	auto options = Options{};
+	// --bench sets the frame count too, so the two may not both be given
+	auto frameCountGiven = false;
+
+	for (auto it = std::begin(args); it != std::end(args); ++it) {
+		auto const flag      = std::string_view{*it};
+		auto const nextValue = [&]() -> std::string_view
+		{
+			if (std::next(it) == std::end(args)) {
+				throw std::invalid_argument{fmt::format("missing value for {}", flag)};
+			}
+			return *++it;
+		};
+
+		if (flag == "--help"sv or flag == "-h"sv) {
+			options.showHelp = true;
+		} else if (flag == "--headless"sv) {
+			options.headless = true;
+		} else if (flag == "--width"sv) {
+			options.width = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--height"sv) {
+			options.height = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--frames"sv) {
+			options.frameCount = parseInteger<std::uint32_t>(flag, nextValue());
+			frameCountGiven    = true;
+		} else if (flag == "--readback"sv) {
+			options.readbackDirectory = std::filesystem::path{nextValue()};
+		} else if (flag == "--bench"sv) {
+			options.benchFrames = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--bench-output"sv) {
+			options.benchOutput = std::filesystem::path{nextValue()};
+		} else if (flag == "--load-threads"sv) {
+			options.loadThreads = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--optimise-mesh"sv) {
+			options.meshOptimisation = parseMeshOptimisation(flag, nextValue());
+		} else if (flag == "--shader-dir"sv) {
+			options.shaderDirectory = std::filesystem::path{nextValue()};
+		} else if (flag == "--record-threads"sv) {
+			options.recordThreads = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--draw-copies"sv) {
+			options.drawCopies = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--instances"sv) {
+			options.instanceCount = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--gpu-culling"sv) {
+			options.gpuCulling = true;
+		} else if (flag == "--sim-rate"sv) {
+			options.simulationRate = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--frames-in-flight"sv) {
+			options.framesInFlight = parseInteger<std::uint32_t>(flag, nextValue());
+		} else if (flag == "--present-mode"sv) {
+			options.presentMode = parsePresentMode(flag, nextValue());
+		} else if (flag == "--low-latency"sv) {
+			options.lowLatency = true;
+		} else if (flag == "--idle"sv) {
+			options.idle = true;
+		} else {
+			throw std::invalid_argument{fmt::format("unknown option: '{}'\n{}", flag, usage())};
+		}
+	}
+
+	if (options.benchFrames.has_value()) {
+		if (frameCountGiven) {
+			throw std::invalid_argument{"--bench <count> sets the number of frames, so it does not take --frames"};
+		}
+		options.frameCount = *options.benchFrames;
+	}
+	if (options.width == 0u or options.height == 0u) {
+		throw std::invalid_argument{"--width and --height must be non-zero"};
+	}
+	if (options.readbackDirectory.has_value() and not options.headless) {
+		throw std::invalid_argument{"--readback requires --headless"};
+	}
+	if (options.drawCopies == 0u or options.instanceCount == 0u or options.framesInFlight == 0u) {
+		throw std::invalid_argument{"--draw-copies, --instances and --frames-in-flight must be non-zero"};
+	}
+	if (options.idle and (options.headless or options.benchFrames.has_value() or options.simulationRate == 0u)) {
+		throw std::invalid_argument{"--idle redraws a window when its scene changes, so it needs the simulation thread and a window, "
+		                            "and takes none of --headless, --bench or --sim-rate 0"};
+	}
+	if (options.headless and (options.presentMode != PresentMode::automatic or options.lowLatency)) {
+		throw std::invalid_argument{"--present-mode and --low-latency pace presentation and input, so neither goes with --headless"};
+	}
+	if (options.gpuCulling and (options.recordThreads > 0u or options.drawCopies > 1u)) {
+		throw std::invalid_argument{"--gpu-culling records a single indirect draw, so it takes neither --record-threads nor --draw-copies"};
+	}
+
+	return options;
+}
+
+auto usage() -> std::string_view
+{
+	return R"(usage: vulkan_tutorial [options]
+	--help, -h           show this message
+	--headless           render into device-owned images; no window, surface or swapchain
+	--width <pixels>     framebuffer width (default 800)
+	--height <pixels>    framebuffer height (default 800)
+	--frames <count>     number of frames to render in headless mode (default 100)
+	--readback <dir>     headless only: write every rendered frame to <dir> as PNG
+	--bench <count>      render <count> frames along a fixed camera path and report frame timings; replaces --frames
+	--bench-output <path>
+	                     where to write the benchmark report (default bench.json)
+	--load-threads <count>
+	                     threads used to parse the model (default 0: one per hardware thread)
+	--optimise-mesh <none|cache|overdraw>
+	                     reorder the parsed model for the post-transform cache, then also for overdraw, and report
+	                     ACMR/ATVR before and after (default none)
+	--shader-dir <dir>   load triangle.vert.spv, triangle.frag.spv and cull.comp.spv from <dir> instead of the copies built
+	                     into the executable, e.g. to try shader edits without relinking
+	--record-threads <count>
+	                     record the draws into secondary command buffers on <count> threads, the main thread
+	                     included (default 0: record inline into the primary on the main thread)
+	--draw-copies <count>
+	                     issue every draw <count> times, to load command recording (default 1)
+	--instances <count>  draw <count> copies of the model on a grid, all in one instanced draw (default 1)
+	--gpu-culling        cull the instances against the view frustum in a compute pass and draw the survivors with
+	                     drawIndexedIndirectCount; needs the drawIndirectCount and drawIndirectFirstInstance features
+	--sim-rate <steps>   advance the scene <steps> times a second on a thread of its own, rendering frames interpolated
+	                     between steps (default 120; 0 advances it on the render thread, as --bench always does)
+	--frames-in-flight <count>
+	                     frames the CPU may prepare while the GPU works on earlier ones; more smooths out spikes at the
+	                     cost of latency (default 2)
+	--present-mode <auto|fifo|mailbox|immediate>
+	                     swapchain present mode; auto takes mailbox where supported and FIFO otherwise (default auto)
+	--low-latency        wait for the GPU to finish the last frame before sampling input, so each frame is built from
+	                     input as fresh as possible; this runs one frame in flight whatever --frames-in-flight says, and
+	                     input-to-submit latency is in the --bench report either way
+	--idle               draw only when the scene moves or the window needs it, sleeping in the event queue in between;
+	                     space pauses and resumes the scene in any mode, and on exit the time spent idle is reported
+)"sv;
+}
+}// namespace HelloTriangle
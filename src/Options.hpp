@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace HelloTriangle
+{
+inline constexpr auto INIT_WIDTH  = 800u;
+inline constexpr auto INIT_HEIGHT = 800u;
+
+// passes run over a freshly parsed model; each level includes the ones before it, and any level also remaps for vertex fetch
+enum class MeshOptimisation : std::uint8_t
+{
+	none,
+	vertexCache,
+	overdraw,
+};
+
+// automatic takes mailbox where the surface offers it and FIFO otherwise; any other mode must be supported or startup fails
+enum class PresentMode : std::uint8_t
+{
+	automatic,
+	fifo,
+	mailbox,
+	immediate,
+};
+
+struct Options
+{
+	bool                                 showHelp{};
+	bool                                 headless{};
+	std::uint32_t                        width{INIT_WIDTH};
+	std::uint32_t                        height{INIT_HEIGHT};
+	std::uint32_t                        frameCount{100u};
+	std::optional<std::filesystem::path> readbackDirectory{};
+	std::optional<std::uint32_t>         benchFrames{};
+	std::filesystem::path                benchOutput{"bench.json"};
+	std::uint32_t                        loadThreads{};
+	MeshOptimisation                     meshOptimisation{MeshOptimisation::none};
+	std::optional<std::filesystem::path> shaderDirectory{};
+	std::uint32_t                        recordThreads{};
+	std::uint32_t                        drawCopies{1u};
+	std::uint32_t                        instanceCount{1u};
+	bool                                 gpuCulling{};
+	std::uint32_t                        simulationRate{120u};
+	std::uint32_t                        framesInFlight{2u};
+	PresentMode                          presentMode{PresentMode::automatic};
+	bool                                 lowLatency{};
+	bool                                 idle{};
+};
+
+auto parseOptions(std::span<char const* const>) -> Options;
+auto usage() -> std::string_view;
+}// namespace HelloTriangle
@@ -0,0 +1,150 @@
+#include "ParallelRecorder.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto makeThreadFrame(vkr::Device const& device, std::uint32_t const queueFamily)
+{
+	// transient: the whole pool is reset every time its frame comes round
+	auto pool     = device.createCommandPool(vk::CommandPoolCreateInfo{vk::CommandPoolCreateFlagBits::eTransient, queueFamily});
+	auto commands = std::move(vkr::CommandBuffers{device, vk::CommandBufferAllocateInfo{*pool, vk::CommandBufferLevel::eSecondary, 1u}}.front());
+
+	return std::pair{std::move(pool), std::move(commands)};
+}
+}// namespace
+
+ParallelRecorder::ParallelRecorder(vkr::Device const&  device,
+                                   std::uint32_t const queueFamily,
+                                   std::uint32_t const framesInFlight,
+                                   std::uint32_t const threadCount)
+{
+	if (threadCount == 0u) {
+		throw std::invalid_argument{"a parallel recorder needs at least one thread"};
+	}
+
+	perThread.resize(threadCount);
+	for (auto& frames : perThread) {
+		frames.reserve(framesInFlight);
+		for (auto frame = std::uint32_t{0}; frame < framesInFlight; ++frame) {
+			auto [pool, commands] = makeThreadFrame(device, queueFamily);
+			frames.push_back({std::move(pool), std::move(commands)});
+		}
+	}
+
+	workers.reserve(threadCount - 1u);
+	for (auto thread = std::size_t{1}; thread < threadCount; ++thread) {
+		workers.emplace_back([this, thread](std::stop_token const stop) { work(stop, thread); });
+	}
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+	// requested under the mutex so that no worker can miss the wake-up between testing its predicate and waiting
+	{
+		auto const lock = std::scoped_lock{mutex};
+		for (auto& worker : workers) {
+			worker.request_stop();
+		}
+	}
+	jobReady.notify_all();
+	workers.clear();
+}
+
+auto ParallelRecorder::record(std::uint32_t const                     frame,
+                              vk::CommandBufferInheritanceInfo const& inheritance,
+                              std::size_t const                       drawCount,
+                              RecordDraws const&                      recordDraws) -> std::span<vk::CommandBuffer const>
+{
+	auto const current = Job{frame, &inheritance, drawCount, &recordDraws};
+	{
+		auto const lock = std::scoped_lock{mutex};
+		job             = current;
+		pending         = workers.size();
+		failure         = nullptr;
+		++generation;
+	}
+	jobReady.notify_all();
+
+	// the first share is recorded here rather than handed off, so one thread means no hand-off at all
+	auto localFailure = std::exception_ptr{};
+	try {
+		recordShare(0u, current);
+	} catch (...) {
+		localFailure = std::current_exception();
+	}
+
+	{
+		auto lock = std::unique_lock{mutex};
+		jobDone.wait(lock, [this] { return pending == 0u; });
+		if (not localFailure) {
+			localFailure = failure;
+		}
+	}
+	if (localFailure) {
+		std::rethrow_exception(localFailure);
+	}
+
+	recorded.clear();
+	std::ranges::transform(perThread, std::back_inserter(recorded), [frame](auto const& frames) { return *frames.at(frame).commands; });
+
+	return recorded;
+}
+
+auto ParallelRecorder::recordShare(std::size_t const thread, Job const& share) -> void
+{
+	auto const& [pool, commands] = perThread.at(thread).at(share.frame);
+	pool.reset();
+
+	// contiguous shares keep the draw order; every buffer is begun and ended even when its share is empty
+	auto const threads = perThread.size();
+	auto const first   = share.drawCount * thread / threads;
+	auto const last    = share.drawCount * (thread + 1u) / threads;
+
+	commands.begin(vk::CommandBufferBeginInfo{
+	    vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, share.inheritance});
+	if (first != last) {
+		(*share.recordDraws)(commands, first, last - first);
+	}
+	commands.end();
+}
+
+auto ParallelRecorder::work(std::stop_token const& stop, std::size_t const thread) -> void
+{
+	auto seen = std::uint64_t{0};
+	while (true) {
+		auto current = Job{};
+		{
+			auto lock = std::unique_lock{mutex};
+			jobReady.wait(lock, [&] { return stop.stop_requested() or generation != seen; });
+			if (stop.stop_requested()) {
+				return;
+			}
+			seen    = generation;
+			current = job;
+		}
+
+		auto error = std::exception_ptr{};
+		try {
+			recordShare(thread, current);
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		{
+			auto const lock = std::scoped_lock{mutex};
+			if (error and not failure) {
+				failure = error;
+			}
+			--pending;
+		}
+		jobDone.notify_one();
+	}
+}
+}// namespace HelloTriangle
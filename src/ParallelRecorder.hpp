@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// Splits a draw list across threads, each recording its contiguous share into a secondary command buffer that continues the
+// caller's render pass; the caller then executes the buffers, in draw order, from its primary. The calling thread records the first
+// share and threadCount - 1 persistent workers record the rest. Every thread owns one command pool per frame in flight, so pools are
+// never shared between threads and a frame's pool is only reset once that frame's fence has signalled.
+class ParallelRecorder
+{
+public:
+	// records draws [first, first + count) into a secondary buffer that has already begun; state is not inherited from the primary
+	using RecordDraws = std::function<void(vkr::CommandBuffer const&, std::size_t first, std::size_t count)>;
+
+	ParallelRecorder(vkr::Device const&, std::uint32_t queueFamily, std::uint32_t framesInFlight, std::uint32_t threadCount);
+	ParallelRecorder(ParallelRecorder const&)                    = delete;
+	auto operator=(ParallelRecorder const&) -> ParallelRecorder& = delete;
+	~ParallelRecorder();
+
+	// blocks until every share is recorded; the returned buffers stay valid until this frame index is recorded again
+	[[nodiscard]] auto record(std::uint32_t frame, vk::CommandBufferInheritanceInfo const&, std::size_t drawCount, RecordDraws const&)
+	    -> std::span<vk::CommandBuffer const>;
+	[[nodiscard]] auto threadCount() const -> std::uint32_t { return static_cast<std::uint32_t>(perThread.size()); }
+
+private:
+	struct ThreadFrame
+	{
+		vkr::CommandPool   pool;
+		vkr::CommandBuffer commands;
+	};
+
+	struct Job
+	{
+		std::uint32_t                           frame{};
+		vk::CommandBufferInheritanceInfo const* inheritance{};
+		std::size_t                             drawCount{};
+		RecordDraws const*                      recordDraws{};
+	};
+
+	std::vector<std::vector<ThreadFrame>> perThread;
+	std::vector<vk::CommandBuffer>        recorded{};
+
+	// the current job, published under the mutex; generation tells workers it is new and pending counts those still recording
+	std::mutex                mutex{};
+	std::condition_variable   jobReady{};
+	std::condition_variable   jobDone{};
+	Job                       job{};
+	std::uint64_t             generation{};
+	std::size_t               pending{};
+	std::exception_ptr        failure{};
+	std::vector<std::jthread> workers{};
+
+	auto recordShare(std::size_t thread, Job const&) -> void;
+	auto work(std::stop_token const&, std::size_t thread) -> void;
+};
+}// namespace HelloTriangle
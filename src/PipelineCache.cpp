@@ -0,0 +1,110 @@
+#include "PipelineCache.hpp"
+
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fmt/format.h>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace HelloTriangle
+{
+namespace fs = std::filesystem;
+
+namespace
+{
+// the header every pipeline cache's data starts with, as VK_PIPELINE_CACHE_HEADER_VERSION_ONE lays it out
+struct CacheHeader
+{
+	std::uint32_t                          headerSize{};
+	std::uint32_t                          headerVersion{};
+	std::uint32_t                          vendorID{};
+	std::uint32_t                          deviceID{};
+	std::array<std::uint8_t, VK_UUID_SIZE> pipelineCacheUUID{};
+};
+static_assert(sizeof(CacheHeader) == 32u);
+
+auto matchesDevice(std::span<std::byte const> const data, vk::PhysicalDeviceProperties const& properties) -> bool
+{
+	auto header = CacheHeader{};
+	if (data.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	return header.headerSize >= sizeof(header) and header.headerVersion == static_cast<std::uint32_t>(vk::PipelineCacheHeaderVersion::eOne) and
+	       header.vendorID == properties.vendorID and header.deviceID == properties.deviceID and
+	       std::ranges::equal(header.pipelineCacheUUID, properties.pipelineCacheUUID);
+}
+
+// the file's contents if it was written for this device and driver, otherwise nothing
+auto loadInitialData(fs::path const& path, vk::PhysicalDeviceProperties const& properties) -> std::vector<std::byte>
+{
+	if (auto error = std::error_code{}; not fs::is_regular_file(path, error) or fs::file_size(path, error) == 0u) {
+		return {};
+	}
+
+	auto const file  = MappedFile{path};
+	auto const bytes = file.bytes();
+	if (not matchesDevice(bytes, properties)) {
+		fmt::print("pipeline cache {} was written by another device or driver, starting empty\n", path.string());
+		return {};
+	}
+
+	return {std::begin(bytes), std::end(bytes)};
+}
+
+auto makeCache(vkr::Device const& device, std::span<std::byte const> const initialData) -> vkr::PipelineCache
+{
+	return device.createPipelineCache(vk::PipelineCacheCreateInfo{{}, initialData.size(), initialData.data()});
+}
+}// namespace
+
+PipelineCache::PipelineCache(vkr::Device const& device, vkr::PhysicalDevice const& physicalDevice, fs::path cachePath)
+    : path{std::move(cachePath)},
+      properties{physicalDevice.getProperties()},
+      cache{makeCache(device, loadInitialData(path, properties))}
+{}
+
+PipelineCache::~PipelineCache()
+{
+	// losing the cache only costs the next start its compilation, which is no reason to fail shutdown
+	try {
+		save();
+	} catch (std::exception const& e) {
+		fmt::print(stderr, "failed to save pipeline cache: {}\n", e.what());
+	}
+}
+
+auto PipelineCache::save() const -> void
+{
+	auto const data = cache.getData();
+	if (not matchesDevice(std::as_bytes(std::span{data}), properties)) {
+		throw std::runtime_error{"the driver returned pipeline cache data without a valid header"};
+	}
+
+	if (path.has_parent_path()) {
+		fs::create_directories(path.parent_path());
+	}
+	auto const temporaryPath = fs::path{path}.concat(".tmp");
+
+	{
+		auto stream = std::ofstream{temporaryPath, std::ios::binary | std::ios::trunc};
+		stream.write(reinterpret_cast<char const*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		if (not stream) {
+			throw std::runtime_error{fmt::format("failed to write pipeline cache {}", temporaryPath.string())};
+		}
+	}
+
+	fs::rename(temporaryPath, path);
+}
+}// namespace HelloTriangle
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// A driver pipeline cache seeded from a file, so that pipelines compiled by an earlier run are not compiled again. A file whose
+// header names another vendor, device or pipelineCacheUUID (which changes with the driver) is ignored rather than handed to the
+// driver. The cache is written back on destruction, to a temporary file renamed into place, so a crash never leaves a torn file.
+class PipelineCache
+{
+public:
+	PipelineCache(vkr::Device const&, vkr::PhysicalDevice const&, std::filesystem::path);
+	PipelineCache(PipelineCache const&)                    = delete;
+	auto operator=(PipelineCache const&) -> PipelineCache& = delete;
+	~PipelineCache();
+
+	[[nodiscard]] auto get() const -> vkr::PipelineCache const& { return cache; }
+	auto               save() const -> void;
+
+private:
+	std::filesystem::path              path;
+	vk::PhysicalDeviceProperties const properties;
+	vkr::PipelineCache                 cache;
+};
+}// namespace HelloTriangle
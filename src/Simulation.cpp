@@ -0,0 +1,93 @@
+#include "Simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+constexpr auto ROTATION_SPEED = std::numbers::pi / 2.0;// radians a second
+}// namespace
+
+auto advance(SceneState const& state, double const seconds) -> SceneState { return {state.rotation + ROTATION_SPEED * seconds}; }
+
+auto interpolate(SceneState const& from, SceneState const& to, double const fraction) -> SceneState
+{
+	return {std::lerp(from.rotation, to.rotation, fraction)};
+}
+
+Simulation::Simulation(std::uint32_t const stepsPerSecond, std::function<void()> onStep)
+    : step{stepsPerSecond == 0u ? throw std::invalid_argument{"a simulation needs a non-zero step rate"}
+                                : std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{1.0 / stepsPerSecond})}
+    , onStep{std::move(onStep)}
+{
+	// published before the thread starts, so the render thread always has something to sample
+	auto const first = Snapshot{{}, {}, Clock::now()};
+	snapshots.publish(first);
+
+	thread = std::jthread{[this, first](std::stop_token const stop) { run(stop, first); }};
+}
+
+auto Simulation::sample(Clock::time_point const now) -> SceneState
+{
+	auto const& [previous, current, currentTime] = snapshots.latest();
+	auto const fraction = std::chrono::duration<double>{now - currentTime} / std::chrono::duration<double>{step};
+
+	return interpolate(previous, current, std::clamp(fraction, 0.0, 1.0));
+}
+
+// stored under the lock, so a simulation thread about to wait cannot miss being resumed
+auto Simulation::setPaused(bool const pause) -> void
+{
+	{
+		auto const lock = std::scoped_lock{pauseMutex};
+		holding.store(pause, std::memory_order_relaxed);
+	}
+	resumed.notify_all();
+}
+
+auto Simulation::paused() const -> bool { return holding.load(std::memory_order_relaxed); }
+
+auto Simulation::run(std::stop_token const& stop, Snapshot snapshot) -> void
+{
+	auto const seconds = std::chrono::duration<double>{step}.count();
+
+	// sleeping to an absolute time keeps the steps on a fixed grid, however long each one takes; stopping waits out at most one step
+	while (not stop.stop_requested()) {
+		snapshot.currentTime += step;
+		std::this_thread::sleep_until(snapshot.currentTime);
+
+		// read once, so the thread never sleeps on a step that moved the scene
+		auto const holdStill = paused();
+		snapshot.previous    = std::exchange(snapshot.current, advance(snapshot.current, holdStill ? 0.0 : seconds));
+		publish(snapshot);
+
+		if (holdStill) {
+			if (not waitWhilePaused(stop)) {
+				return;
+			}
+			// the time spent paused is skipped rather than caught up
+			snapshot.currentTime = Clock::now();
+		}
+	}
+}
+
+auto Simulation::publish(Snapshot const& snapshot) -> void
+{
+	snapshots.publish(snapshot);
+	if (onStep) {
+		onStep();
+	}
+}
+
+// false once a stop has been requested
+auto Simulation::waitWhilePaused(std::stop_token const& stop) -> bool
+{
+	auto lock = std::unique_lock{pauseMutex};
+	return resumed.wait(lock, stop, [this] { return not paused(); });
+}
+}// namespace HelloTriangle
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TripleBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+namespace HelloTriangle
+{
+// everything about the scene that changes over time
+struct SceneState
+{
+	double rotation{};// radians about z; never wrapped, so interpolating between two states cannot cross a seam
+
+	auto operator==(SceneState const&) const -> bool = default;
+};
+
+[[nodiscard]] auto advance(SceneState const&, double seconds) -> SceneState;
+[[nodiscard]] auto interpolate(SceneState const& from, SceneState const& to, double fraction) -> SceneState;
+
+// Advances the scene on a thread of its own in fixed steps, so that neither a long frame nor a slow step can disturb the other.
+// Each step publishes the state before and after it through a triple buffer; the render thread samples them one step behind real
+// time, blending the two by how far it is into the step. A step that runs late is caught up rather than lengthened. While paused the
+// thread sleeps until it is resumed, so a still scene costs nothing; steps then start again from the time of resuming.
+class Simulation
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// onStep, if any, is called on the simulation thread after each step is published, for waking a render thread that waits for them
+	explicit Simulation(std::uint32_t stepsPerSecond, std::function<void()> onStep = {});
+
+	// render thread only
+	[[nodiscard]] auto sample(Clock::time_point now) -> SceneState;
+	// the next step leaves the scene as it is, so it holds still once that step has been shown; the thread then sleeps until resumed
+	auto               setPaused(bool) -> void;
+	[[nodiscard]] auto paused() const -> bool;
+
+private:
+	struct Snapshot
+	{
+		SceneState        previous;
+		SceneState        current;
+		Clock::time_point currentTime;
+	};
+
+	Clock::duration const       step;
+	std::function<void()> const onStep;
+	TripleBuffer<Snapshot>      snapshots{};
+	std::atomic<bool>           holding{};
+	std::mutex                  pauseMutex{};
+	std::condition_variable_any resumed{};
+	std::jthread                thread{};
+
+	auto               run(std::stop_token const&, Snapshot) -> void;
+	auto               publish(Snapshot const&) -> void;
+	[[nodiscard]] auto waitWhilePaused(std::stop_token const&) -> bool;
+};
+}// namespace HelloTriangle
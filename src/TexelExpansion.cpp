@@ -0,0 +1,117 @@
+#include "TexelExpansion.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fmt/format.h>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TEXEL_EXPANSION_SSSE3
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SSSE3_TARGET
+#else
+#include <immintrin.h>
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#elif defined(__ARM_NEON)
+#define TEXEL_EXPANSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace HelloTriangle
+{
+namespace
+{
+constexpr auto OPAQUE = std::uint8_t{0xFFu};
+
+// converts count texels from the start of each buffer
+auto expandRgbScalar(std::uint8_t const* source, std::uint8_t* destination, std::size_t const count) -> void
+{
+	for (auto i = std::size_t{0}; i < count; ++i, source += 3, destination += 4) {
+		destination[0] = source[0];
+		destination[1] = source[1];
+		destination[2] = source[2];
+		destination[3] = OPAQUE;
+	}
+}
+
+#if defined(TEXEL_EXPANSION_SSSE3)
+auto hasSsse3() -> bool
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	auto info = std::array<int, 4>{};
+	__cpuid(info.data(), 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+// four texels per shuffle; each 16-byte load reads 4 bytes past the 12 it uses, so the last texels are left to the scalar loop
+SSSE3_TARGET auto expandRgbSsse3(std::uint8_t const* const source, std::uint8_t* const destination, std::size_t const count) -> std::size_t
+{
+	auto const shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	auto const alpha   = _mm_set1_epi32(static_cast<int>(0xFF00'0000u));
+
+	auto texel = std::size_t{0};
+	for (; texel + 6u <= count; texel += 4u) {
+		auto const rgb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + texel * 3u));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + texel * 4u), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+	}
+
+	return texel;
+}
+#elif defined(TEXEL_EXPANSION_NEON)
+// sixteen texels per de-interleaving load
+auto expandRgbNeon(std::uint8_t const* const source, std::uint8_t* const destination, std::size_t const count) -> std::size_t
+{
+	auto texel = std::size_t{0};
+	for (; texel + 16u <= count; texel += 16u) {
+		auto const rgb  = vld3q_u8(source + texel * 3u);
+		auto const rgba = uint8x16x4_t{{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(OPAQUE)}};
+		vst4q_u8(destination + texel * 4u, rgba);
+	}
+
+	return texel;
+}
+#endif
+
+auto expandRgb(std::uint8_t const* const source, std::uint8_t* const destination, std::size_t const count) -> void
+{
+	auto done = std::size_t{0};
+#if defined(TEXEL_EXPANSION_SSSE3)
+	static auto const ssse3 = hasSsse3();
+	if (ssse3) {
+		done = expandRgbSsse3(source, destination, count);
+	}
+#elif defined(TEXEL_EXPANSION_NEON)
+	done = expandRgbNeon(source, destination, count);
+#endif
+	expandRgbScalar(source + done * 3u, destination + done * 4u, count - done);
+}
+}// namespace
+
+auto expandToRgba(std::span<std::byte const> const source, std::uint32_t const channels, std::span<std::byte> const rgba) -> void
+{
+	if (channels < 1u or channels > 4u or source.size() % channels != 0u) {
+		throw std::invalid_argument{fmt::format("cannot expand {} bytes of {}-channel texels", source.size(), channels)};
+	}
+	auto const count = source.size() / channels;
+	if (rgba.size() < count * 4u) {
+		throw std::length_error{fmt::format("{} texels do not fit in {} bytes of RGBA", count, rgba.size())};
+	}
+
+	auto const from = reinterpret_cast<std::uint8_t const*>(source.data());
+	auto const to   = reinterpret_cast<std::uint8_t*>(rgba.data());
+	switch (channels) {
+	case 4u: std::ranges::copy(source, std::begin(rgba)); break;
+	case 3u: expandRgb(from, to, count); break;
+	default:
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			std::fill_n(to + i * 4u, 3u, from[i * channels]);
+			to[i * 4u + 3u] = channels == 2u ? from[i * channels + 1u] : OPAQUE;
+		}
+	}
+}
+}// namespace HelloTriangle
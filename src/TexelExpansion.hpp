@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace HelloTriangle
+{
+// Widens 8-bit texels with 1 to 4 channels (grey, grey-alpha, RGB or RGBA, as stb_image returns them) to RGBA, writing straight
+// into rgba, which is typically mapped staging memory. Grey is replicated into red, green and blue, and missing alpha is opaque.
+// RGB, the common case for photographic textures, uses an SSSE3 or NEON kernel where the CPU has one.
+auto expandToRgba(std::span<std::byte const> source, std::uint32_t channels, std::span<std::byte> rgba) -> void;
+}// namespace HelloTriangle
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+// Hands the latest value from one writer thread to one reader thread without either ever waiting on the other. Each side owns a
+// slot of its own and they trade through a third: the writer fills its slot and swaps it into the middle, marking it fresh, and
+// the reader swaps the middle for its slot only when it is fresh. A value the reader has not picked up yet is simply overwritten.
+template<typename Value>
+class TripleBuffer
+{
+public:
+	// writer thread only
+	auto publish(Value const& value) -> void
+	{
+		slots.at(back) = value;
+		back           = middle.exchange(static_cast<std::uint8_t>(back | FRESH), std::memory_order_acq_rel) & INDEX;
+	}
+
+	// reader thread only; until something is published again this returns the same value as last time
+	[[nodiscard]] auto latest() -> Value const&
+	{
+		if ((middle.load(std::memory_order_relaxed) & FRESH) != 0u) {
+			front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		}
+
+		return slots.at(front);
+	}
+
+private:
+	static constexpr auto INDEX = std::uint8_t{0b011u};
+	static constexpr auto FRESH = std::uint8_t{0b100u};
+
+	std::array<Value, 3>      slots{};
+	std::atomic<std::uint8_t> middle{1u};
+	// on separate cache lines, since each is written by its own thread
+	alignas(64) std::uint8_t back{0u};
+	alignas(64) std::uint8_t front{2u};
+};
+}// namespace HelloTriangle
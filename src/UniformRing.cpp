@@ -0,0 +1,60 @@
+#include "UniformRing.hpp"
+
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto alignUp(vk::DeviceSize const value, vk::DeviceSize const alignment) -> vk::DeviceSize
+{
+	return (value + alignment - 1u) / alignment * alignment;
+}
+
+auto makeRingBuffer(vkr::Device const& device, DeviceAllocator& allocator, vk::DeviceSize const size) -> BufferAndMemory
+{
+	// memory the GPU reads at full speed when the device can also map it, as with resizable BAR or a unified memory architecture
+	constexpr auto hostCoherent   = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+	constexpr auto deviceCoherent = hostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+	auto       buffer     = device.createBuffer(vk::BufferCreateInfo{{}, size, vk::BufferUsageFlagBits::eUniformBuffer});
+	auto const typeBits   = buffer.getMemoryRequirements().memoryTypeBits;
+	auto       allocation = allocator.allocateFor(buffer, allocator.hasMemoryType(typeBits, deviceCoherent) ? deviceCoherent : hostCoherent);
+
+	return {std::move(buffer), std::move(allocation)};
+}
+}// namespace
+
+UniformRing::UniformRing(vkr::Device const&              device,
+                         DeviceAllocator&                allocator,
+                         vk::PhysicalDeviceLimits const& limits,
+                         std::uint32_t const             framesInFlight,
+                         vk::DeviceSize const            bytesPerFrame)
+    : alignment{limits.minUniformBufferOffsetAlignment},
+      regionSize{alignUp(bytesPerFrame, alignment)},
+      ring{makeRingBuffer(device, allocator, regionSize * framesInFlight)},
+      mapped{static_cast<std::byte*>(ring.allocation.mappedData())}
+{}
+
+auto UniformRing::beginFrame(std::uint32_t const frame) -> void
+{
+	regionStart = regionSize * frame;
+	used        = 0u;
+}
+
+auto UniformRing::push(std::span<std::byte const> const block) -> std::uint32_t
+{
+	if (used + block.size() > regionSize) {
+		throw std::length_error{fmt::format("{} bytes of uniform data overflow a {} byte frame region", used + block.size(), regionSize)};
+	}
+
+	auto const offset = regionStart + used;
+	std::memcpy(mapped + offset, block.data(), block.size());
+	used = alignUp(used + block.size(), alignment);
+
+	return static_cast<std::uint32_t>(offset);
+}
+}// namespace HelloTriangle
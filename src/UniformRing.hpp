@@ -0,0 +1,42 @@
+#pragma once
+
+#include "DeviceAllocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// One persistently mapped uniform buffer, split into a region per frame in flight, for data that changes every frame. A frame
+// appends each block it needs to its region and binds the buffer once through an eUniformBufferDynamic descriptor at the offset
+// push returned, so per-draw data costs a memcpy and a dynamic offset, and nothing is allocated or written to a descriptor set
+// while frames run. A region is rewound when its frame index comes round again, which must be after that frame's fence has signalled.
+class UniformRing
+{
+public:
+	UniformRing(vkr::Device const&, DeviceAllocator&, vk::PhysicalDeviceLimits const&, std::uint32_t framesInFlight, vk::DeviceSize bytesPerFrame);
+
+	auto               beginFrame(std::uint32_t frame) -> void;
+	// copies the block to the current frame's region, returning the dynamic offset it is bound at; throws once the region is full
+	[[nodiscard]] auto push(std::span<std::byte const>) -> std::uint32_t;
+	template<typename Block>
+	[[nodiscard]] auto push(Block const& block) -> std::uint32_t
+	{
+		return push(std::as_bytes(std::span{&block, 1u}));
+	}
+
+	[[nodiscard]] auto buffer() const -> vk::Buffer { return *ring.buffer; }
+
+private:
+	vk::DeviceSize const alignment;
+	vk::DeviceSize const regionSize;
+	BufferAndMemory      ring;
+	std::byte*           mapped;
+	vk::DeviceSize       regionStart{};
+	vk::DeviceSize       used{};
+};
+}// namespace HelloTriangle
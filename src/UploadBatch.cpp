@@ -0,0 +1,267 @@
+#include "UploadBatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace HelloTriangle
+{
+namespace
+{
+auto hasStencilComponent(vk::Format const& format) -> bool { return format == vk::Format::eD32SfloatS8Uint or format == vk::Format::eD24UnormS8Uint; }
+
+auto allocateCommandBuffer(vkr::Device const& device, vkr::CommandPool const& commandPool) -> vkr::CommandBuffer
+{
+	auto const     allocInfo     = vk::CommandBufferAllocateInfo{*commandPool, vk::CommandBufferLevel::ePrimary, 1u};
+	auto           commandBuffer = std::move(device.allocateCommandBuffers(allocInfo).front());
+	constexpr auto beginInfo     = vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
+
+	commandBuffer.begin(beginInfo);
+
+	return commandBuffer;
+}
+}// namespace
+
+UploadBatch::UploadBatch(vkr::Device const&      logicalDevice,
+                         vkr::CommandPool const& commandPool,
+                         DeviceAllocator&        deviceAllocator,
+                         QueueFamilyTransfer     queueFamilies)
+    : device{logicalDevice},
+      allocator{deviceAllocator},
+      ownership{queueFamilies},
+      commands{allocateCommandBuffer(logicalDevice, commandPool)},
+      fence{logicalDevice.createFence(vk::FenceCreateInfo{})}
+{}
+
+UploadBatch::~UploadBatch()
+{
+	// the staging buffers must outlive the copies reading from them
+	if (submitted and not released) {
+		std::ignore = device.waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	}
+}
+
+auto UploadBatch::stage(std::span<std::byte const> const bytes) -> vk::Buffer
+{
+	auto const staging = reserveStaging(bytes.size());
+	std::ranges::copy(bytes, std::begin(staging.bytes));
+
+	return staging.buffer;
+}
+
+auto UploadBatch::reserveStaging(vk::DeviceSize const size, bool const hostReads) -> StagingMemory
+{
+	if (submitted) {
+		throw std::logic_error{"cannot stage data into an upload batch that has already been submitted"};
+	}
+
+	auto       buffer   = device.createBuffer(vk::BufferCreateInfo{{}, size, vk::BufferUsageFlagBits::eTransferSrc});
+	auto const typeBits = buffer.getMemoryRequirements().memoryTypeBits;
+
+	// uncached (often write-combined) memory is fine to write but very slow to read
+	auto const coherent   = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+	auto const cached     = coherent | vk::MemoryPropertyFlagBits::eHostCached;
+	auto const properties = hostReads and allocator.hasMemoryType(typeBits, cached) ? cached : vk::MemoryPropertyFlags{coherent};
+
+	auto allocation = allocator.allocateFor(buffer, properties);
+
+	auto const staging = StagingMemory{*buffer, {static_cast<std::byte*>(allocation.mappedData()), static_cast<std::size_t>(size)}};
+	stagingBuffers.push_back({std::move(buffer), std::move(allocation)});
+
+	return staging;
+}
+
+auto UploadBatch::copyBuffer(vk::Buffer const& srcBuffer, vk::Buffer const& dstBuffer, vk::DeviceSize const size) -> void
+{
+	commands.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy{{}, {}, size});
+
+	if (ownership.required()) {
+		bufferReleases.emplace_back(
+		    vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eNone, ownership.source, ownership.destination, dstBuffer, 0u, VK_WHOLE_SIZE);
+		bufferAcquires.emplace_back(
+		    vk::AccessFlagBits::eNone, vk::AccessFlagBits::eMemoryRead, ownership.source, ownership.destination, dstBuffer, 0u, VK_WHOLE_SIZE);
+	}
+}
+
+auto UploadBatch::copyBufferToImage(vk::Buffer const&    buffer,
+                                    vk::Image const&     image,
+                                    std::uint32_t const  width,
+                                    std::uint32_t const  height,
+                                    std::uint32_t const  mipLevel,
+                                    vk::DeviceSize const bufferOffset) const -> void
+{
+	auto const region = vk::BufferImageCopy{
+	    bufferOffset, 0u, 0u, vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, mipLevel, 0u, 1u}, {0, 0, 0}, {width, height, 1u}};
+
+	commands.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
+}
+
+auto UploadBatch::transitionImageLayout(vk::Image const&       image,
+                                        vk::Format const&      format,
+                                        vk::ImageLayout const& oldLayout,
+                                        vk::ImageLayout const& newLayout,
+                                        std::uint32_t const    mipLevels) -> void
+{
+	auto const getAspectMask = [&format](vk::ImageLayout const& newLayout) -> vk::ImageAspectFlags
+	{
+		if (newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) {
+			if (hasStencilComponent(format)) {
+				return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+			}
+			return vk::ImageAspectFlagBits::eDepth;
+		}
+		return vk::ImageAspectFlagBits::eColor;
+	};
+
+	transitionSubresource(image, vk::ImageSubresourceRange{getAspectMask(newLayout), 0u, mipLevels, 0u, 1u}, oldLayout, newLayout);
+}
+
+auto UploadBatch::generateMipmaps(vk::Image const& image, std::uint32_t const width, std::uint32_t const height, std::uint32_t const mipLevels)
+    -> void
+{
+	auto const levelRange  = [](std::uint32_t const level) { return vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, level, 1u, 0u, 1u}; };
+	auto const levelLayers = [](std::uint32_t const level) { return vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, level, 0u, 1u}; };
+	auto const levelBounds = [=](std::uint32_t const level)
+	{
+		auto const corner =
+		    vk::Offset3D{static_cast<std::int32_t>(std::max(width >> level, 1u)), static_cast<std::int32_t>(std::max(height >> level, 1u)), 1};
+		return std::array{vk::Offset3D{}, corner};
+	};
+
+	for (auto level = std::uint32_t{1}; level < mipLevels; ++level) {
+		transitionSubresource(image, levelRange(level - 1u), vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal);
+
+		auto const blit = vk::ImageBlit{levelLayers(level - 1u), levelBounds(level - 1u), levelLayers(level), levelBounds(level)};
+		commands.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+		transitionSubresource(image, levelRange(level - 1u), vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+
+	transitionSubresource(image, levelRange(mipLevels - 1u), vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
+auto UploadBatch::transitionSubresource(vk::Image const&                  image,
+                                        vk::ImageSubresourceRange const& subresourceRange,
+                                        vk::ImageLayout const&           oldLayout,
+                                        vk::ImageLayout const&           newLayout) -> void
+{
+	constexpr static auto getMasksAndStages =
+	    [](vk::ImageLayout const& oldLayout,
+	       vk::ImageLayout const& newLayout) -> std::tuple<vk::AccessFlags, vk::AccessFlags, vk::PipelineStageFlags, vk::PipelineStageFlags>
+	{
+		if (oldLayout == vk::ImageLayout::eUndefined and newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) {
+			return {vk::AccessFlagBits::eNone,
+			        vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+			        vk::PipelineStageFlagBits::eTopOfPipe,
+			        vk::PipelineStageFlagBits::eEarlyFragmentTests};
+		}
+		if (oldLayout == vk::ImageLayout::eUndefined and newLayout == vk::ImageLayout::eTransferDstOptimal) {
+			return {vk::AccessFlagBits::eNone,
+			        vk::AccessFlagBits::eTransferWrite,
+			        vk::PipelineStageFlagBits::eTopOfPipe,
+			        vk::PipelineStageFlagBits::eTransfer};
+		}
+		if (oldLayout == vk::ImageLayout::eTransferDstOptimal and newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+			return {vk::AccessFlagBits::eTransferWrite,
+			        vk::AccessFlagBits::eShaderRead,
+			        vk::PipelineStageFlagBits::eTransfer,
+			        vk::PipelineStageFlagBits::eFragmentShader};
+		}
+		if (oldLayout == vk::ImageLayout::eTransferDstOptimal and newLayout == vk::ImageLayout::eTransferSrcOptimal) {
+			return {vk::AccessFlagBits::eTransferWrite,
+			        vk::AccessFlagBits::eTransferRead,
+			        vk::PipelineStageFlagBits::eTransfer,
+			        vk::PipelineStageFlagBits::eTransfer};
+		}
+		if (oldLayout == vk::ImageLayout::eTransferSrcOptimal and newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+			return {vk::AccessFlagBits::eTransferRead,
+			        vk::AccessFlagBits::eShaderRead,
+			        vk::PipelineStageFlagBits::eTransfer,
+			        vk::PipelineStageFlagBits::eFragmentShader};
+		}
+		throw std::invalid_argument{"Unsupported layout transition"};
+	};
+
+	auto const [srcAccessMask, dstAccessMask, srcStage, dstStage] = getMasksAndStages(oldLayout, newLayout);
+
+	// a transition for a consumer on another queue family doubles as the ownership transfer; both halves must describe it identically
+	if (ownership.required() and dstStage != vk::PipelineStageFlagBits::eTransfer) {
+		imageReleases.emplace_back(
+		    srcAccessMask, vk::AccessFlagBits::eNone, oldLayout, newLayout, ownership.source, ownership.destination, image, subresourceRange);
+		imageAcquires.emplace_back(
+		    vk::AccessFlagBits::eNone, dstAccessMask, oldLayout, newLayout, ownership.source, ownership.destination, image, subresourceRange);
+		return;
+	}
+
+	auto const barrier = vk::ImageMemoryBarrier{srcAccessMask,
+	                                            dstAccessMask,
+	                                            oldLayout,
+	                                            newLayout,
+	                                            VK_QUEUE_FAMILY_IGNORED,
+	                                            VK_QUEUE_FAMILY_IGNORED,
+	                                            image,
+	                                            subresourceRange};
+
+	commands.pipelineBarrier(srcStage, dstStage, {}, {}, {}, barrier);
+}
+
+auto UploadBatch::submit(vkr::Queue const& queue, vk::Semaphore const& timeline, std::uint64_t const signalValue) -> void
+{
+	if (submitted) {
+		throw std::logic_error{"upload batch submitted twice"};
+	}
+
+	if (ownership.required()) {
+		if (not bufferReleases.empty() or not imageReleases.empty()) {
+			commands.pipelineBarrier(
+			    vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, bufferReleases, imageReleases);
+		}
+	} else {
+		// later submissions on the same queue are ordered after this barrier, so they can use the uploads without waiting on the fence
+		auto const barrier =
+		    vk::MemoryBarrier{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite};
+		commands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, barrier, {}, {});
+	}
+	commands.end();
+
+	if (timeline) {
+		auto const timelineInfo = vk::TimelineSemaphoreSubmitInfo{{}, signalValue};
+		queue.submit(vk::SubmitInfo{{}, {}, *commands, timeline, &timelineInfo}, *fence);
+	} else {
+		queue.submit(vk::SubmitInfo{{}, {}, *commands, {}}, *fence);
+	}
+	submitted = true;
+}
+
+auto UploadBatch::complete() const -> bool { return released or (submitted and fence.getStatus() == vk::Result::eSuccess); }
+
+auto UploadBatch::releaseIfComplete() -> bool
+{
+	if (released) {
+		return true;
+	}
+	if (not complete()) {
+		return false;
+	}
+
+	stagingBuffers.clear();
+	commands.clear();
+	released = true;
+
+	return true;
+}
+
+auto UploadBatch::recordAcquire(vkr::CommandBuffer const& commandBuffer) const -> void
+{
+	if (bufferAcquires.empty() and imageAcquires.empty()) {
+		return;
+	}
+
+	// the submission containing this must wait for the batch's semaphore signal at all commands, matching the source stage here
+	commandBuffer.pipelineBarrier(
+	    vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, {}, bufferAcquires, imageAcquires);
+}
+}// namespace HelloTriangle
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "DeviceAllocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace HelloTriangle
+{
+namespace vkr = vk::raii;
+
+// Queue families a batch's resources move between; equal families mean no ownership transfer is needed.
+struct QueueFamilyTransfer
+{
+	std::uint32_t source{VK_QUEUE_FAMILY_IGNORED};
+	std::uint32_t destination{VK_QUEUE_FAMILY_IGNORED};
+
+	[[nodiscard]] auto required() const -> bool { return source != destination; }
+};
+
+// A staging buffer handed out for the caller to fill in place, e.g. by decoding straight into it; writable until the batch is submitted.
+struct StagingMemory
+{
+	vk::Buffer           buffer;
+	std::span<std::byte> bytes;
+};
+
+// Records any number of staging copies and layout transitions into one command buffer, submitted once with a fence.
+// Staging buffers stay alive until that fence has signalled. A batch is single use: record, submit, then release.
+// When the batch runs on another queue family, every destination resource is released to the consuming family on submit, and that
+// family's first command buffer to use them must record the matching acquire barriers.
+class UploadBatch
+{
+public:
+	UploadBatch(vkr::Device const&, vkr::CommandPool const&, DeviceAllocator&, QueueFamilyTransfer = {});
+	UploadBatch(UploadBatch const&)                    = delete;
+	auto operator=(UploadBatch const&) -> UploadBatch& = delete;
+	~UploadBatch();
+
+	// copy bytes into a host-visible staging buffer owned by the batch
+	[[nodiscard]] auto stage(std::span<std::byte const>) -> vk::Buffer;
+	// an uninitialised staging buffer; hostReads asks for cached memory, for callers that read back what they write
+	[[nodiscard]] auto reserveStaging(vk::DeviceSize, bool hostReads = false) -> StagingMemory;
+
+	auto               copyBuffer(vk::Buffer const&, vk::Buffer const&, vk::DeviceSize) -> void;
+	// copy one mip level of width x height texels, read from bufferOffset onwards
+	auto               copyBufferToImage(
+	    vk::Buffer const&, vk::Image const&, std::uint32_t, std::uint32_t, std::uint32_t mipLevel = 0u, vk::DeviceSize bufferOffset = 0u) const
+	    -> void;
+	// transition the first mipLevels levels together
+	auto               transitionImageLayout(
+	    vk::Image const&, vk::Format const&, vk::ImageLayout const&, vk::ImageLayout const&, std::uint32_t mipLevels = 1u) -> void;
+	// Fill levels 1 to mipLevels - 1 by successive linear blits from level 0; every level must be in transfer-dst layout, and all
+	// end up shader-read-only. Blits need a queue with graphics support and a format that supports linear filtering.
+	auto               generateMipmaps(vk::Image const&, std::uint32_t width, std::uint32_t height, std::uint32_t mipLevels) -> void;
+
+	// optionally signal a timeline semaphore value alongside the fence
+	auto               submit(vkr::Queue const&, vk::Semaphore const& timeline = {}, std::uint64_t signalValue = 0u) -> void;
+	[[nodiscard]] auto complete() const -> bool;
+	// free the staging buffers and command buffer once the GPU is done with them; returns whether that has happened
+	auto               releaseIfComplete() -> bool;
+	// take ownership of the uploaded resources on the destination queue family; a no-op without an ownership transfer
+	auto               recordAcquire(vkr::CommandBuffer const&) const -> void;
+
+private:
+	vkr::Device const&                   device;
+	DeviceAllocator&                     allocator;
+	QueueFamilyTransfer const            ownership;
+	vkr::CommandBuffer                   commands;
+	vkr::Fence                           fence;
+	std::vector<BufferAndMemory>         stagingBuffers{};
+	std::vector<vk::BufferMemoryBarrier> bufferReleases{};
+	std::vector<vk::ImageMemoryBarrier>  imageReleases{};
+	std::vector<vk::BufferMemoryBarrier> bufferAcquires{};
+	std::vector<vk::ImageMemoryBarrier>  imageAcquires{};
+	bool                                 submitted{};
+	bool                                 released{};
+
+	auto transitionSubresource(vk::Image const&, vk::ImageSubresourceRange const&, vk::ImageLayout const&, vk::ImageLayout const&) -> void;
+};
+}// namespace HelloTriangle
@@ -1,12 +1,20 @@
 #include "HelloTriangleApplication.hpp"
+#include "Options.hpp"
 
 #include <cstdlib>
 #include <iostream>
+#include <span>
 
-auto main() -> int
+auto main(int argc, char** argv) -> int
 {
 	try {
-		HelloTriangle::Application app{};
+		auto const options = HelloTriangle::parseOptions(std::span{argv + 1, static_cast<std::size_t>(argc - 1)});
+		if (options.showHelp) {
+			std::cout << HelloTriangle::usage();
+			std::exit(EXIT_SUCCESS);
+		}
+
+		HelloTriangle::Application app{options};
 		app.run();
 	} catch (std::exception const& e) {
 		std::cerr << e.what() << std::endl;
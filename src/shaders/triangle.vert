@@ -1,20 +1,32 @@
 #version 460
 
-layout(set = 0, binding = 0) uniform ModelViewProjectionObject {
-    mat4 model;
+layout(set = 0, binding = 0) uniform ViewProjectionObject {
     mat4 view;
     mat4 projection;
-} mvproj;
+} camera;
 
+// one model matrix per instance, indexed by the instance being drawn
+layout(std430, set = 0, binding = 2) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
+// with QUANTISED_VERTICES the position arrives as unorm in the mesh's bounding box (the model matrices map it back) and there is
+// no colour attribute
 layout(location = 0) in vec3 inPosition;
+#ifndef QUANTISED_VERTICES
 layout(location = 1) in vec3 inColor;
+#endif
 layout(location = 2) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 
 void main() {
-    gl_Position = mvproj.projection * mvproj.view * mvproj.model * vec4(inPosition, 1.0);
+    gl_Position = camera.projection * camera.view * instances.models[gl_InstanceIndex] * vec4(inPosition, 1.0);
+#ifdef QUANTISED_VERTICES
+    fragColor = vec3(1.0);
+#else
     fragColor = inColor;
+#endif
     fragTexCoord = inTexCoord;
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "BlockCompression.hpp"
+#include "Ktx2.hpp"
+#include "MipChain.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fmt/format.h>
+#include <span>
+#include <stb_image.h>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// Converts a PNG or JPEG texture into a mip-mapped, block-compressed KTX2 file for the application to load in its place. The
+// application looks for <name>.bc7.ktx2 and <name>.bc1.ktx2 beside <name>.png, e.g.
+//   texture_encoder src/textures/viking_room.png src/textures/viking_room.bc7.ktx2 bc7
+// usage: texture_encoder <input> <output.ktx2> [bc7|bc1]
+
+namespace
+{
+using namespace HelloTriangle;
+using Clock = std::chrono::steady_clock;
+
+auto parseFormat(std::string_view const name) -> vk::Format
+{
+	if (name == "bc7") {
+		return vk::Format::eBc7SrgbBlock;
+	}
+	if (name == "bc1") {
+		return vk::Format::eBc1RgbSrgbBlock;
+	}
+	throw std::invalid_argument{fmt::format("unknown block format '{}', expected bc7 or bc1", name)};
+}
+}// namespace
+
+auto main(int argc, char* argv[]) -> int
+try {
+	if (argc < 3) {
+		throw std::invalid_argument{"usage: texture_encoder <input> <output.ktx2> [bc7|bc1]"};
+	}
+	auto const inputPath  = std::filesystem::path{argv[1]};
+	auto const outputPath = std::filesystem::path{argv[2]};
+	auto const format     = parseFormat(argc > 3 ? argv[3] : "bc7");
+
+	int        width, height, channels;
+	auto const pixels = stbi_load(inputPath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (pixels == nullptr) {
+		throw std::runtime_error{fmt::format("failed to load {}: {}", inputPath.string(), stbi_failure_reason())};
+	}
+	auto const imageSize = static_cast<std::size_t>(width) * height * STBI_rgb_alpha;
+	auto const chain =
+	    buildSrgbMipChain(std::as_bytes(std::span{pixels, imageSize}), static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height));
+	stbi_image_free(pixels);
+
+	auto const start  = Clock::now();
+	auto       levels = std::vector<std::vector<std::byte>>{};
+	levels.reserve(chain.levels.size());
+	for (auto const& [levelWidth, levelHeight, offset] : chain.levels) {
+		auto const texels = std::span{chain.texels}.subspan(offset, std::size_t{levelWidth} * levelHeight * STBI_rgb_alpha);
+		levels.push_back(format == vk::Format::eBc7SrgbBlock ? encodeBc7(texels, levelWidth, levelHeight)
+		                                                     : encodeBc1(texels, levelWidth, levelHeight));
+	}
+	auto const encodeTime = std::chrono::duration<double>{Clock::now() - start};
+
+	writeKtx2(outputPath, format, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), levels);
+
+	fmt::print("{}: {}x{}, {} levels, {:.1f} KiB of RGBA8 -> {:.1f} KiB in {:.2f} s\n",
+	           outputPath.string(),
+	           width,
+	           height,
+	           levels.size(),
+	           static_cast<double>(chain.texels.size()) / 1024.0,
+	           static_cast<double>(std::filesystem::file_size(outputPath)) / 1024.0,
+	           encodeTime.count());
+
+	return EXIT_SUCCESS;
+} catch (std::exception const& e) {
+	fmt::print(stderr, "{}\n", e.what());
+	return EXIT_FAILURE;
+}